@@ -0,0 +1,153 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: DeadPathSink.cpp                                     */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include "DeadPathSink.h"
+#include "MBUtils.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+DeadPathSink::DeadPathSink()
+{
+  // Init config vars
+  m_mode = "sample";
+  m_sample_size = 500;
+  m_edge_cap = 20000;
+
+  // Init state vars
+  clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: setMode()
+
+bool DeadPathSink::setMode(string mode)
+{
+  mode = tolower(stripBlankEnds(mode));
+  if((mode != "counts") && (mode != "sample") && (mode != "edges"))
+    return(false);
+
+  m_mode = mode;
+  clear();
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void DeadPathSink::clear()
+{
+  m_count_hit  = 0;
+  m_count_side = 0;
+  m_samples.clear();
+  m_edges.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: addDead()
+//   Purpose: Count a dead path whose last leg is x1,y1 to x2,y2.
+//   Returns: In sample mode, the slot the caller should fill with
+//            the full path by setSample(), or -1 if the path is
+//            not kept. Always -1 in other modes.
+//      Note: Reservoir sampling: the n-th path replaces a random
+//            slot with probability N/n.
+
+int DeadPathSink::addDead(double x1, double y1, double x2, double y2,
+			  bool wrong_side)
+{
+  if(wrong_side)
+    m_count_side++;
+  else
+    m_count_hit++;
+
+  if(m_mode == "edges") {
+    if(m_edges.size() < (4 * (size_t)(m_edge_cap))) {
+      m_edges.push_back((float)(x1));
+      m_edges.push_back((float)(y1));
+      m_edges.push_back((float)(x2));
+      m_edges.push_back((float)(y2));
+    }
+    return(-1);
+  }
+
+  if((m_mode != "sample") || (m_sample_size == 0))
+    return(-1);
+
+  if(m_samples.size() < m_sample_size) {
+    m_samples.push_back(XYSegList());
+    return(m_samples.size() - 1);
+  }
+
+  unsigned long n = getCount();
+  unsigned long j = (unsigned long)(m_rng.uniform() * (double)(n));
+  if(j < m_sample_size)
+    return(j);
+  return(-1);
+}
+
+//---------------------------------------------------------------
+// Procedure: setSample()
+
+void DeadPathSink::setSample(unsigned int slot, const XYSegList& segl)
+{
+  if(slot < m_samples.size())
+    m_samples[slot] = segl;
+}
+
+//---------------------------------------------------------------
+// Procedure: merge()
+//   Purpose: Fold in the dead paths of another sink, e.g., from
+//            another search thread, with the same mode.
+//      Note: Samples are combined in proportion to the number of
+//            dead paths each sink has seen, so the result stays
+//            close to a uniform sample over both.
+
+void DeadPathSink::merge(const DeadPathSink& other)
+{
+  unsigned long my_count = getCount();
+  unsigned long other_count = other.getCount();
+
+  m_count_hit  += other.m_count_hit;
+  m_count_side += other.m_count_side;
+
+  // Part 1: Edges, up to the cap
+  for(unsigned int i=0; i<other.m_edges.size(); i++) {
+    if(m_edges.size() >= (4 * (size_t)(m_edge_cap)))
+      break;
+    m_edges.push_back(other.m_edges[i]);
+  }
+
+  // Part 2: Samples
+  if(other.m_samples.size() == 0)
+    return;
+  if((m_samples.size() + other.m_samples.size()) <= m_sample_size) {
+    for(unsigned int i=0; i<other.m_samples.size(); i++)
+      m_samples.push_back(other.m_samples[i]);
+    return;
+  }
+
+  double frac = (double)(other_count) / (double)(my_count + other_count);
+  unsigned int take = (unsigned int)(round(frac * m_sample_size));
+  if(take > other.m_samples.size())
+    take = other.m_samples.size();
+  unsigned int keep = m_sample_size - take;
+  if(keep > m_samples.size()) {
+    keep = m_samples.size();
+    take = m_sample_size - keep;
+  }
+
+  m_samples.resize(keep);
+  for(unsigned int i=0; i<take; i++)
+    m_samples.push_back(other.m_samples[i]);
+}
@@ -0,0 +1,75 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: DeadPathSink.h                                       */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef DEAD_PATH_SINK_HEADER
+#define DEAD_PATH_SINK_HEADER
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "XYSegList.h"
+#include "RandGen.h"
+
+//---------------------------------------------------------------
+// Bounded record of the dead paths rejected by a PathField search.
+// Dead paths are always counted. Beyond that, depending on mode:
+//   counts: Nothing more is kept.
+//   sample: A uniform reservoir sample of up to N dead paths.
+//   edges:  The final (rejected) leg of each dead path, as float
+//           coordinates, up to a cap on the number of edges.
+// In sample mode the caller builds the path only when addDead()
+// hands back a slot for it, so most dead paths cost nothing.
+
+class DeadPathSink {
+ public:
+  DeadPathSink();
+  ~DeadPathSink() {}
+
+  bool   setMode(std::string);
+  void   setSampleSize(unsigned int v) {m_sample_size = v;}
+  void   setEdgeCap(unsigned int v)    {m_edge_cap = v;}
+  void   setSeed(uint64_t seed)        {m_rng.setSeed(seed);}
+  void   clear();
+
+  int    addDead(double x1, double y1, double x2, double y2,
+		 bool wrong_side=false);
+  void   setSample(unsigned int slot, const XYSegList&);
+  void   merge(const DeadPathSink&);
+
+  std::string getMode() const {return(m_mode);}
+
+  unsigned long getCount() const      {return(m_count_hit + m_count_side);}
+  unsigned long getCountHit() const   {return(m_count_hit);}
+  unsigned long getCountSide() const  {return(m_count_side);}
+
+  const std::vector<XYSegList>& getSamples() const {return(m_samples);}
+
+  // Edge i runs from (m_edges[4i], m_edges[4i+1]) to
+  // (m_edges[4i+2], m_edges[4i+3])
+  const std::vector<float>& getEdges() const {return(m_edges);}
+  unsigned int getEdgeCount() const {return(m_edges.size() / 4);}
+
+ protected: // State vars
+  unsigned long m_count_hit;
+  unsigned long m_count_side;
+
+  std::vector<XYSegList> m_samples;
+  std::vector<float>     m_edges;
+
+  RandGen m_rng;
+
+ protected: // Config vars
+  std::string  m_mode;
+  unsigned int m_sample_size;
+  unsigned int m_edge_cap;
+};
+
+#endif
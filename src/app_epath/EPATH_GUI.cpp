@@ -70,7 +70,36 @@ void EPATH_GUI::augmentMenu()
   m_menubar->add("Polygons/Enlarge", ']',
 		 (Fl_Callback*)EPATH_GUI::cb_Grow, (void*)1, 0);
   m_menubar->add("Polygons/Shrink",  '[',
-		 (Fl_Callback*)EPATH_GUI::cb_Grow, (void*)-1, 0);
+		 (Fl_Callback*)EPATH_GUI::cb_Grow, (void*)-1, FL_MENU_DIVIDER);
+  m_menubar->add("Polygons/Merge Obstacles", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_MergePolys, (void*)0, 0);
+
+  m_menubar->add("Solve/Mode Random", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_SolveMode, (void*)0, FL_MENU_RADIO|FL_MENU_VALUE);
+  m_menubar->add("Solve/Mode VisGraph", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_SolveMode, (void*)1, FL_MENU_RADIO);
+  m_menubar->add("Solve/Mode Informed RRT*", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_SolveMode, (void*)2,
+		 FL_MENU_RADIO|FL_MENU_DIVIDER);
+
+  m_menubar->add("Solve/Order Depth-First", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_SearchOrder, (void*)0, FL_MENU_RADIO|FL_MENU_VALUE);
+  m_menubar->add("Solve/Order Best-First", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_SearchOrder, (void*)1, FL_MENU_RADIO);
+  m_menubar->add("Solve/Order Beam", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_SearchOrder, (void*)2,
+		 FL_MENU_RADIO|FL_MENU_DIVIDER);
+
+  m_menubar->add("Solve/Warm Start", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_WarmStart, (void*)0,
+		 FL_MENU_TOGGLE|FL_MENU_DIVIDER);
+
+  m_menubar->add("Solve/Deads Counts Only", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_DeadMode, (void*)0, FL_MENU_RADIO);
+  m_menubar->add("Solve/Deads Sample", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_DeadMode, (void*)1, FL_MENU_RADIO|FL_MENU_VALUE);
+  m_menubar->add("Solve/Deads Edges", 0,
+		 (Fl_Callback*)EPATH_GUI::cb_DeadMode, (void*)2, FL_MENU_RADIO);
 
   m_menubar->add("Starts/Start1", '1',
 		 (Fl_Callback*)EPATH_GUI::cb_StartPoints, (void*)1);
@@ -165,14 +194,80 @@ void EPATH_GUI::cb_DrawDeads(Fl_Widget* o) {
 //----------------------------------------- Solve
 void EPATH_GUI::cb_Solve_i(int amt) {
   //pviewer->updateGenPoly();
-  pviewer->solve(amt);
-  pviewer->redraw();
+  if(pviewer->isSolving())
+    return;
+  pviewer->solveStart();
+  Fl::add_timeout(0.05, cb_SolvePoll, (void*)(this));
   updateXY();
 }
 void EPATH_GUI::cb_Solve(Fl_Widget* o, int amt) {
   ((EPATH_GUI*)(o->parent()->user_data()))->cb_Solve_i(10);
 }
 
+//----------------------------------------- SolvePoll
+// Redraws the best path so far while a solve runs on the viewer's
+// worker thread, until the solve is done.
+void EPATH_GUI::cb_SolvePoll(void* v) {
+  EPATH_GUI* gui = (EPATH_GUI*)(v);
+  bool done = gui->pviewer->solvePoll();
+  gui->updateXY();
+  if(!done)
+    Fl::repeat_timeout(0.05, cb_SolvePoll, v);
+}
+
+//----------------------------------------- SolveMode
+void EPATH_GUI::cb_SolveMode_i(int v) {
+  if(v == 1)
+    pviewer->setParam("solve_mode", "vgraph");
+  else if(v == 2)
+    pviewer->setParam("solve_mode", "rrt");
+  else
+    pviewer->setParam("solve_mode", "random");
+  pviewer->redraw();
+  updateXY();
+}
+void EPATH_GUI::cb_SolveMode(Fl_Widget* o, int v) {
+  ((EPATH_GUI*)(o->parent()->user_data()))->cb_SolveMode_i(v);
+}
+
+//----------------------------------------- SearchOrder
+void EPATH_GUI::cb_SearchOrder_i(int v) {
+  if(v == 1)
+    pviewer->setParam("search_order", "best");
+  else if(v == 2)
+    pviewer->setParam("search_order", "beam");
+  else
+    pviewer->setParam("search_order", "depth");
+  updateXY();
+}
+void EPATH_GUI::cb_SearchOrder(Fl_Widget* o, int v) {
+  ((EPATH_GUI*)(o->parent()->user_data()))->cb_SearchOrder_i(v);
+}
+
+//----------------------------------------- WarmStart
+void EPATH_GUI::cb_WarmStart_i() {
+  pviewer->setParam("warm_start", "toggle");
+  updateXY();
+}
+void EPATH_GUI::cb_WarmStart(Fl_Widget* o) {
+  ((EPATH_GUI*)(o->parent()->user_data()))->cb_WarmStart_i();
+}
+
+//----------------------------------------- DeadMode
+void EPATH_GUI::cb_DeadMode_i(int v) {
+  if(v == 0)
+    pviewer->setParam("dead_mode", "counts");
+  else if(v == 2)
+    pviewer->setParam("dead_mode", "edges");
+  else
+    pviewer->setParam("dead_mode", "sample");
+  pviewer->redraw();
+  updateXY();
+}
+void EPATH_GUI::cb_DeadMode(Fl_Widget* o, int v) {
+  ((EPATH_GUI*)(o->parent()->user_data()))->cb_DeadMode_i(v);
+}
+
 //----------------------------------------- ClearPolys
 void EPATH_GUI::cb_ClearPolys_i() {
   pviewer->clearPolys();
@@ -183,6 +278,16 @@ void EPATH_GUI::cb_ClearPolys(Fl_Widget* o) {
   ((EPATH_GUI*)(o->parent()->user_data()))->cb_ClearPolys_i();
 }
 
+//----------------------------------------- MergePolys
+void EPATH_GUI::cb_MergePolys_i() {
+  pviewer->mergePolys();
+  pviewer->redraw();
+  updateXY();
+}
+void EPATH_GUI::cb_MergePolys(Fl_Widget* o) {
+  ((EPATH_GUI*)(o->parent()->user_data()))->cb_MergePolys_i();
+}
+
 //----------------------------------------- ClearSolve
 void EPATH_GUI::cb_ClearSolve_i() {
   pviewer->clearSolve();
@@ -221,9 +326,63 @@ void EPATH_GUI::updateXY()
   sval = doubleToString(dval,2);
   m_fld_solve->value(sval.c_str());
 
+  // Number of dead paths in the last solve
+  sval = ulintToString(pviewer->getDeadCount());
+  m_fld_deads->value(sval.c_str());
+
+  // Run ID of the last random search, to replay it
+  sval = pviewer->getRunID();
+  m_fld_run_id->value(sval.c_str());
+
   sval = pviewer->getSeglShortest();
   m_fld_segl_shortest->value(sval.c_str());
 
   sval = pviewer->getSeglShortestStar();
   m_fld_segl_star->value(sval.c_str());
 }
+
+//----------------------------------------- UpdateMenus
+// Sets the Solve menu radio and toggle items from the viewer,
+// e.g., after command line params are applied.
+void EPATH_GUI::updateMenus()
+{
+  string mode = pviewer->getSolveMode();
+  string mode_item = "Solve/Mode Random";
+  if(mode == "vgraph")
+    mode_item = "Solve/Mode VisGraph";
+  else if(mode == "rrt")
+    mode_item = "Solve/Mode Informed RRT*";
+
+  string order = pviewer->getSearchOrder();
+  string order_item = "Solve/Order Depth-First";
+  if(order == "best")
+    order_item = "Solve/Order Best-First";
+  else if(order == "beam")
+    order_item = "Solve/Order Beam";
+
+  string deads = pviewer->getDeadMode();
+  string deads_item = "Solve/Deads Sample";
+  if(deads == "counts")
+    deads_item = "Solve/Deads Counts Only";
+  else if(deads == "edges")
+    deads_item = "Solve/Deads Edges";
+
+  Fl_Menu_Item *item = 0;
+  item = (Fl_Menu_Item*)(m_menubar->find_item(mode_item.c_str()));
+  if(item)
+    item->setonly();
+  item = (Fl_Menu_Item*)(m_menubar->find_item(order_item.c_str()));
+  if(item)
+    item->setonly();
+  item = (Fl_Menu_Item*)(m_menubar->find_item(deads_item.c_str()));
+  if(item)
+    item->setonly();
+
+  item = (Fl_Menu_Item*)(m_menubar->find_item("Solve/Warm Start"));
+  if(item) {
+    if(pviewer->getWarmStart())
+      item->set();
+    else
+      item->clear();
+  }
+}
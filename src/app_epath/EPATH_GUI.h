@@ -26,6 +26,7 @@ public:
   ~EPATH_GUI() {}
   
   void updateXY();
+  void updateMenus();
   int  handle(int);
 
 protected:
@@ -45,6 +46,8 @@ protected:
   Fl_Output  *m_fld_snap;
   Fl_Output  *m_fld_polys;
   Fl_Output  *m_fld_solve;
+  Fl_Output  *m_fld_run_id;
+  Fl_Output  *m_fld_deads;
 
   Fl_Output  *m_fld_segl_shortest;
   Fl_Output  *m_fld_segl_star;
@@ -61,10 +64,26 @@ private:
 
   inline void cb_Solve_i(int);
   static void cb_Solve(Fl_Widget*, int);
+  static void cb_SolvePoll(void*);
+
+  inline void cb_SolveMode_i(int);
+  static void cb_SolveMode(Fl_Widget*, int);
+
+  inline void cb_SearchOrder_i(int);
+  static void cb_SearchOrder(Fl_Widget*, int);
+
+  inline void cb_WarmStart_i();
+  static void cb_WarmStart(Fl_Widget*);
+
+  inline void cb_DeadMode_i(int);
+  static void cb_DeadMode(Fl_Widget*, int);
 
   inline void cb_ClearPolys_i();
   static void cb_ClearPolys(Fl_Widget*);
 
+  inline void cb_MergePolys_i();
+  static void cb_MergePolys(Fl_Widget*);
+
   inline void cb_ClearSolve_i();
   static void cb_ClearSolve(Fl_Widget*);
 
@@ -50,6 +50,12 @@ void EPATH_GUI::initWidgets()
   m_fld_solve = new Fl_Output(0, 0, 1, 1, "solve:"); 
   m_fld_solve->set_output();
 
+  m_fld_run_id = new Fl_Output(0, 0, 1, 1, "run:"); 
+  m_fld_run_id->set_output();
+
+  m_fld_deads = new Fl_Output(0, 0, 1, 1, "deads:"); 
+  m_fld_deads->set_output();
+
   //----------------------------------------------------------
   m_fld_segl_shortest = new Fl_Output(0, 0, 1, 1, "shortest:"); 
   m_fld_segl_shortest->set_output();
@@ -121,6 +127,17 @@ void EPATH_GUI::resizeWidgetsShape()
   int sot_wid = wid4;
   m_fld_solve->resize(sot_x, sot_y, sot_wid, field_hgt);
 
+  //-------------------- Column 5
+  int dds_x = col5;
+  int dds_y = row1;
+  int dds_wid = wid5 + 50;
+  m_fld_deads->resize(dds_x, dds_y, dds_wid, field_hgt);
+
+  int rid_x = col5;
+  int rid_y = row2;
+  int rid_wid = wid5 + 50;
+  m_fld_run_id->resize(rid_x, rid_y, rid_wid, field_hgt);
+
   //-------------------- Column 7
   int clep_x = col7;
   int clep_y = row1;
@@ -171,6 +188,12 @@ void EPATH_GUI::resizeWidgetsText()
   m_fld_solve->textsize(text_size);
   m_fld_solve->labelsize(label_size);
 
+  m_fld_run_id->textsize(text_size);
+  m_fld_run_id->labelsize(label_size);
+
+  m_fld_deads->textsize(text_size);
+  m_fld_deads->labelsize(label_size);
+
   m_fld_segl_shortest->textsize(text_size);
   m_fld_segl_shortest->labelsize(label_size);
 
@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <string>
+#include <cstdlib>
 #include "MBTimer.h"
 #include "EPathViewer.h"
 #include "MBUtils.h"
@@ -42,14 +43,27 @@ EPathViewer::EPathViewer(int x, int y, int w, int h, const char *l)
   m_snap_val     = 2.0;
   m_solve_collap = true;
   m_solve_method = "shallow"; 
+  m_solve_budget = 0;
 
   // State vars init
   m_solve_time = 0;
+  m_draw_revision = 0;
+  m_draw_cache_ok = false;
+  m_solving = false;
+  m_solve_done = false;
 
   m_pfield.setSource(-50,-100);
   m_pfield.setDest(110,-70);
 }
 
+//------------------------------------------------------------
+// Destructor()
+
+EPathViewer::~EPathViewer()
+{
+  solveHalt();
+}
+
 //-------------------------------------------------------------
 // Procedure: handle()
 
@@ -74,6 +88,10 @@ int EPathViewer::handle(int event)
 	handle_mouse_poly(vx, vy);
       }
 
+      else if((Fl::event_button() == FL_LEFT_MOUSE) &&
+	 (Fl::event_state(FL_ALT)))
+	handle_mouse_side_pref(vx, vy);
+
       else if((Fl::event_button() == FL_LEFT_MOUSE) &&
 	 (!Fl::event_state(FL_CTRL)) &&
 	 (!Fl::event_state(FL_SHIFT)))
@@ -132,15 +150,84 @@ void EPathViewer::draw()
   // ------------------------------------------------------
   // Draw Polys
   // ------------------------------------------------------
+  if(!m_solving &&
+     (!m_draw_cache_ok || (m_draw_revision != m_pfield.getRevision())))
+    refreshDrawCache();
+
+  for(unsigned int i=0; i<m_draw_polys.size(); i++)
+    drawPolygon(m_draw_polys[i]);
+  
+  // ------------------------------------------------------
+  // Draw Segls
+  // ------------------------------------------------------
+  if(m_draw_deads) {
+    for(unsigned int i=0; i<m_draw_segls_dead.size(); i++)
+      drawSegList(m_draw_segls_dead[i]);
+  }
+
+  if(m_solving) {
+    double dist;
+    if(m_pfield.getProgress(m_draw_progress, dist)) {
+      m_draw_progress.set_edge_color("yellow");
+      m_draw_progress.set_vertex_color("white");
+      drawSegList(m_draw_progress);
+    }
+  }
+  else if(m_pfield.getFocusPoly() < 0) {
+    if(m_draw_shortest.size() > 0)
+      drawSegList(m_draw_shortest);
+  }
+  else {
+    if(m_draw_shortest_port.size() > 0)
+      drawSegList(m_draw_shortest_port);
+    if(m_draw_shortest_star.size() > 0)
+      drawSegList(m_draw_shortest_star);
+  }
+
+  if(!m_solving && (m_draw_smooth.size() > 0))
+    drawSegList(m_draw_smooth);
+}
+
+//-------------------------------------------------------------
+// Procedure: refreshDrawCache()
+//   Purpose: Rebuild the colored copies of the polys and paths.
+//            Called from draw() only when the path field has
+//            changed, so a static scene is drawn without copies.
+
+void EPathViewer::refreshDrawCache()
+{
   int focus_poly = m_pfield.getFocusPoly();
   
-  vector<XYPolygon> polys = m_pfield.getPolys();
+  const vector<XYPolygon>& polys = m_pfield.getPolys();
+  m_draw_polys.clear();
+
+  // With a clearance, the inflated pieces are drawn as outlines
+  // under the obstacles they grow from
+  if(m_pfield.getClearance() > 0) {
+    const vector<XYPolygon>& pieces = m_pfield.getPieces();
+    for(unsigned int i=0; i<pieces.size(); i++) {
+      XYPolygon piece = pieces[i];
+      piece.set_label("");
+      piece.set_color("fill", "invisible");
+      piece.set_edge_color("gray70");
+      piece.set_vertex_color("invisible");
+      m_draw_polys.push_back(piece);
+    }
+  }
+
   for(unsigned int i=0; i<polys.size(); i++) {
     XYPolygon poly = polys[i];
     poly.set_color("fill", "gray50");
     poly.set_edge_color("white");
     poly.set_vertex_color("dodger_blue");
 
+    // Side preferences are shown by edge color
+    string side_pref = m_pfield.getSidePref(i);
+    if(side_pref == "port")
+      poly.set_edge_color("green");
+    else if(side_pref == "star")
+      poly.set_edge_color("red");
+
     if(focus_poly >= 0) {
       if(focus_poly == i)
 	poly.set_color("fill", "orange");
@@ -152,46 +239,49 @@ void EPathViewer::draw()
       else if(pass_side == "port")
 	poly.set_color("fill", "green");
     }
-    
-    drawPolygon(poly);
-  }
-  
-  // ------------------------------------------------------
-  // Draw Segls
-  // ------------------------------------------------------
-  if(m_draw_deads) {
-    vector<XYSegList> segls;
-    segls = m_pfield.getSeglsDead();
-    for(unsigned int i=0; i<segls.size(); i++) {
-      XYSegList segl = segls[i];
-      segl.set_edge_color("white");
-      segl.set_vertex_color("white");
-      drawSegList(segl);
-    }
+    m_draw_polys.push_back(poly);
   }
 
-  if(m_pfield.getFocusPoly() < 0) {
-    XYSegList segl_shortest = m_pfield.getSeglShortest();
-    if(segl_shortest.size() > 0) {
-      segl_shortest.set_edge_color("green");
-      segl_shortest.set_vertex_color("white");  
-      drawSegList(segl_shortest);
-    }
+  // Dead paths are drawn from whatever the dead path sink keeps:
+  // a sample of whole paths, or the final leg of each
+  const DeadPathSink& dead_sink = m_pfield.getDeadSink();
+  const vector<XYSegList>& segls = dead_sink.getSamples();
+  m_draw_segls_dead.clear();
+  for(unsigned int i=0; i<segls.size(); i++) {
+    XYSegList segl = segls[i];
+    segl.set_edge_color("white");
+    segl.set_vertex_color("white");
+    m_draw_segls_dead.push_back(segl);
   }
-  else {
-    XYSegList seglp = m_pfield.getSeglShortestPort();
-    if(seglp.size() > 0) {
-      seglp.set_edge_color("pink");
-      seglp.set_vertex_color("white");  
-      drawSegList(seglp);
-    }
-    XYSegList segls = m_pfield.getSeglShortestStar();
-    if(segls.size() > 0) {
-      segls.set_edge_color("green");
-      segls.set_vertex_color("white");  
-      drawSegList(segls);
-    }
+
+  const vector<float>& edges = dead_sink.getEdges();
+  for(unsigned int i=0; (i+3)<edges.size(); i+=4) {
+    XYSegList segl;
+    segl.add_vertex(edges[i],   edges[i+1]);
+    segl.add_vertex(edges[i+2], edges[i+3]);
+    segl.set_edge_color("white");
+    segl.set_vertex_color("white");
+    m_draw_segls_dead.push_back(segl);
   }
+
+  m_draw_shortest = m_pfield.getSeglShortest();
+  m_draw_shortest.set_edge_color("green");
+  m_draw_shortest.set_vertex_color("white");  
+
+  m_draw_shortest_port = m_pfield.getSeglShortestPort();
+  m_draw_shortest_port.set_edge_color("pink");
+  m_draw_shortest_port.set_vertex_color("white");  
+
+  m_draw_shortest_star = m_pfield.getSeglShortestStar();
+  m_draw_shortest_star.set_edge_color("green");
+  m_draw_shortest_star.set_vertex_color("white");  
+
+  m_draw_smooth = m_pfield.getSeglSmooth();
+  m_draw_smooth.set_edge_color("cyan");
+  m_draw_smooth.set_vertex_color("invisible");
+
+  m_draw_revision = m_pfield.getRevision();
+  m_draw_cache_ok = true;
 }
 
 //-------------------------------------------------------------
@@ -199,12 +289,12 @@ void EPathViewer::draw()
 
 void EPathViewer::handle_mouse_src(int vx, int vy)
 {
+  solveHalt();
   double ix = view2img('x', vx);
   double iy = view2img('y', vy);
   double mx = img2meters('x', ix);
   double my = img2meters('y', iy);
-  m_pfield.setSource(mx, my);
-  m_pfield.clearSolve();
+  m_pfield.moveSource(mx, my);
 
   redraw();
 }
@@ -214,12 +304,12 @@ void EPathViewer::handle_mouse_src(int vx, int vy)
 
 void EPathViewer::handle_mouse_dest(int vx, int vy)
 {
+  solveHalt();
   double ix = view2img('x', vx);
   double iy = view2img('y', vy);
   double mx = img2meters('x', ix);
   double my = img2meters('y', iy);
-  m_pfield.setDest(mx, my);
-  m_pfield.clearSolve();
+  m_pfield.moveDest(mx, my);
 
   redraw();
 }
@@ -229,6 +319,7 @@ void EPathViewer::handle_mouse_dest(int vx, int vy)
 
 void EPathViewer::handle_mouse_poly(int vx, int vy)
 {
+  solveHalt();
   double ix = view2img('x', vx);
   double iy = view2img('y', vy);
   double mx = img2meters('x', ix);
@@ -250,6 +341,7 @@ void EPathViewer::handle_mouse_poly(int vx, int vy)
 
 void EPathViewer::handle_mouse_focus_poly(int vx, int vy)
 {
+  solveHalt();
   double ix = view2img('x', vx);
   double iy = view2img('y', vy);
   double mx = img2meters('x', ix);
@@ -261,6 +353,22 @@ void EPathViewer::handle_mouse_focus_poly(int vx, int vy)
 }
 
 
+//-------------------------------------------------------------
+// Procedure: handle_mouse_side_pref()
+
+void EPathViewer::handle_mouse_side_pref(int vx, int vy)
+{
+  solveHalt();
+  double ix = view2img('x', vx);
+  double iy = view2img('y', vy);
+  double mx = img2meters('x', ix);
+  double my = img2meters('y', iy);
+
+  m_pfield.cycleSidePref(mx,my);
+
+  redraw();
+}
+
 //-------------------------------------------------------------
 // Procedure: setParam()
 
@@ -272,13 +380,103 @@ bool EPathViewer::setParam(string param, string value)
   if(MarineViewer::setParam(param, value))
     return(true);
 
+  if((param == "solve_mode") || (param == "dead_mode") ||
+     (param == "seed") || (param == "threads") ||
+     (param == "rrt_budget") || (param == "warm_start") ||
+     (param == "search_order") || (param == "beam_width") ||
+     (param == "node_budget") || (param == "genpoly") ||
+     (param == "clearance") || (param == "arc_tol") ||
+     (param == "turn_radius") || (param == "src_hdg") ||
+     (param == "merge_gap") || (param == "merge_hulls"))
+    solveHalt();
+
   bool handled = true;
   if(param == "view_polygon") 
     m_segl = string2SegList(value);
   else if(param == "view_seglist")
     m_segl = string2SegList(value);
+  else if(param == "genpoly") {
+    XYSegList border = string2SegList(value);
+    handled = (border.size() >= 3);
+    if(handled) {
+      CoverEngine engine;
+      engine.setPoints(border);
+      m_pfield.addGenPoly(engine.getGenPoly());
+    }
+  }
   else if(param == "draw_deads") 
     setBooleanOnString(m_draw_deads, value);
+  else if(param == "warm_start") {
+    bool warm_start = m_pfield.getWarmStart();
+    handled = setBooleanOnString(warm_start, value);
+    m_pfield.setWarmStart(warm_start);
+  }
+  else if(param == "solve_mode")
+    handled = m_pfield.setSolveMode(value);
+  else if(param == "dead_mode")
+    handled = m_pfield.setDeadMode(value);
+  else if(param == "seed") {
+    handled = isNumber(value);
+    if(handled)
+      m_pfield.setSeed(strtoul(value.c_str(), 0, 10));
+  }
+  else if(param == "threads") {
+    handled = isNumber(value);
+    if(handled)
+      m_pfield.setThreads(atoi(value.c_str()));
+  }
+  else if(param == "rrt_budget") {
+    handled = isNumber(value) && (atof(value.c_str()) > 0);
+    if(handled)
+      m_pfield.setRRTBudget(atof(value.c_str()));
+  }
+  else if(param == "search_order")
+    handled = m_pfield.setSearchOrder(value);
+  else if(param == "beam_width") {
+    handled = isNumber(value) && (atoi(value.c_str()) > 0);
+    if(handled)
+      m_pfield.setBeamWidth(atoi(value.c_str()));
+  }
+  else if(param == "node_budget") {
+    handled = isNumber(value) && (atoi(value.c_str()) > 0);
+    if(handled)
+      m_pfield.setNodeBudget(atoi(value.c_str()));
+  }
+  else if(param == "clearance") {
+    handled = isNumber(value) && (atof(value.c_str()) >= 0);
+    if(handled)
+      m_pfield.setClearance(atof(value.c_str()));
+  }
+  else if(param == "arc_tol") {
+    handled = isNumber(value) && (atof(value.c_str()) > 0);
+    if(handled)
+      m_pfield.setArcTol(atof(value.c_str()));
+  }
+  else if(param == "merge_gap") {
+    handled = isNumber(value) && (atof(value.c_str()) >= 0);
+    if(handled)
+      m_pfield.setMergeGap(atof(value.c_str()));
+  }
+  else if(param == "merge_hulls") {
+    bool merge_hulls = m_pfield.getMergeHulls();
+    handled = setBooleanOnString(merge_hulls, value);
+    m_pfield.setMergeHulls(merge_hulls);
+  }
+  else if(param == "turn_radius") {
+    handled = isNumber(value) && (atof(value.c_str()) >= 0);
+    if(handled)
+      m_pfield.setTurnRadius(atof(value.c_str()));
+  }
+  else if(param == "src_hdg") {
+    handled = isNumber(value);
+    if(handled)
+      m_pfield.setSrcHdg(angle360(atof(value.c_str())));
+  }
+  else if(param == "solve_budget") {
+    handled = isNumber(value) && (atof(value.c_str()) >= 0);
+    if(handled)
+      m_solve_budget = atof(value.c_str());
+  }
   else if(param == "verbose") 
     setBooleanOnString(m_verbose, value);
   
@@ -327,6 +525,7 @@ bool EPathViewer::setParam(string param, double pval)
 
 void EPathViewer::clearPolys()
 {  
+  solveHalt();
   m_pfield.clearPolys();
   m_segl.clear();
   //m_hull_poly.clear();
@@ -334,11 +533,26 @@ void EPathViewer::clearPolys()
   m_solve_time = 0;
 }
 
+// ----------------------------------------------------------
+// Procedure: mergePolys()
+
+void EPathViewer::mergePolys()
+{
+  solveHalt();
+  unsigned int old_pieces = m_pfield.getPieces().size();
+  unsigned int merged = m_pfield.mergeObstacles();
+  m_solve_time = 0;
+
+  cout << "Merged " << merged << " obstacles, pieces: " << old_pieces;
+  cout << " -> " << m_pfield.getPieces().size() << endl;
+}
+
 // ----------------------------------------------------------
 // Procedure: clearSolve()
 
 void EPathViewer::clearSolve()
 {  
+  solveHalt();
   m_pfield.clearSolve();
   m_segl.clear();
   //m_hull_poly.clear();
@@ -347,11 +561,72 @@ void EPathViewer::clearSolve()
 }
 
 // ----------------------------------------------------------
-// Procedure: solve()
+// Procedure: solveStart()
+//   Purpose: Start a solve on a worker thread, so the viewer can
+//            keep drawing the best path so far while it runs. The
+//            GUI is expected to call solvePoll() until it is done.
 
-void EPathViewer::solve(unsigned int amt)
+void EPathViewer::solveStart()
 {
-  m_pfield.solve();
+  if(m_solving)
+    return;
+
+  m_solving = true;
+  m_solve_done = false;
+  m_solve_timer.reset();
+  m_solve_timer.start();
+  m_pfield.prepareSolve(m_solve_budget);
+  m_solve_thread = thread([this]() {
+      m_pfield.runSolve();
+      m_solve_done = true;
+    });
+  redraw();
+}
+
+// ----------------------------------------------------------
+// Procedure: solvePoll()
+//   Purpose: Redraw with the latest progress, and wrap up the solve
+//            once the worker is done.
+//   Returns: true if no solve is running any more.
+
+bool EPathViewer::solvePoll()
+{
+  if(!m_solving)
+    return(true);
+
+  if(!m_solve_done) {
+    redraw();
+    return(false);
+  }
+
+  solveFinish();
+  return(true);
+}
+
+// ----------------------------------------------------------
+// Procedure: solveHalt()
+//   Purpose: Stop a running solve, keeping the best found so far,
+//            and wait for the worker to wind up.
+
+void EPathViewer::solveHalt()
+{
+  if(!m_solving)
+    return;
+
+  m_pfield.stop();
+  solveFinish();
+}
+
+// ----------------------------------------------------------
+// Procedure: solveFinish()
+//   Purpose: Join the worker and note the solve time.
+
+void EPathViewer::solveFinish()
+{
+  m_solve_thread.join();
+  m_solving = false;
+  m_solve_timer.stop();
+  m_solve_time = m_solve_timer.get_float_wall_time();
   redraw();
 }
 
@@ -399,7 +674,12 @@ void EPathViewer::growPoints(int gval)
 
 string EPathViewer::getSeglShortest()
 {
-  XYSegList segl = m_pfield.getSeglShortest();
+  XYSegList segl;
+  double    dist;
+  if(m_solving)
+    m_pfield.getProgress(segl, dist);
+  else
+    segl = m_pfield.getSeglShortest();
   string spec = segl.get_spec();
   return(spec);
 }
@@ -409,6 +689,8 @@ string EPathViewer::getSeglShortest()
 
 string EPathViewer::getSeglShortestStar()
 {
+  if(m_solving)
+    return("");
   XYSegList segl = m_pfield.getSeglShortestStar();
   string spec = segl.get_spec();
   return(spec);
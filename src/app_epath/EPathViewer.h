@@ -13,6 +13,10 @@
 #define POLY_VIEWER_HEADER
 
 #include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "MBTimer.h"
 #include "MarineViewer.h"
 #include "XYSegList.h"
 #include "XYGenPolygon.h"
@@ -22,6 +26,7 @@ class EPathViewer : public MarineViewer
 {
  public:
   EPathViewer(int x,int y,int w,int h,const char *l=0);
+  ~EPathViewer();
   
   // Virtual defined
   void  draw();
@@ -30,15 +35,21 @@ class EPathViewer : public MarineViewer
   bool  setParam(std::string param, double value);
   void  clearPolys();
   void  clearSolve();
+  void  mergePolys();
   
   void  handle_mouse_src(int, int);
   void  handle_mouse_dest(int, int);
   void  handle_mouse_poly(int, int);
   void  handle_mouse_focus_poly(int, int);
+  void  handle_mouse_side_pref(int, int);
+  void  solveFinish();
   
 public:
 
-  void solve(unsigned int);
+  void solveStart();
+  bool solvePoll();
+  void solveHalt();
+  bool isSolving() const {return(m_solving);}
   
   bool getVerbose() const {return(m_verbose);}
   
@@ -52,6 +63,15 @@ public:
 
   unsigned int getPolyCount() const {return(m_gen_poly.getPolyCount());}
   double       getSolveTime() const {return(m_solve_time);}
+  std::string  getSolveMode() const {return(m_pfield.getSolveMode());}
+  std::string  getSearchOrder() const {return(m_pfield.getSearchOrder());}
+  std::string  getDeadMode() const  {return(m_pfield.getDeadMode());}
+  bool         getWarmStart() const {return(m_pfield.getWarmStart());}
+  std::string  getRunID() const
+  {return(m_solving ? "" : m_pfield.getRunID());}
+
+  unsigned long getDeadCount() const
+  {return(m_solving ? 0 : m_pfield.getDeadSink().getCount());}
 
   std::string getSeglShortest();
   std::string getSeglShortestStar();
@@ -59,6 +79,9 @@ public:
   void   updateConvexHull();
   void   updateGenPoly();
 
+private:
+  void   refreshDrawCache();
+
 private: // Config vars
   bool   m_draw_pts;
   bool   m_draw_segl;
@@ -70,6 +93,7 @@ private: // Config vars
   std::string m_solve_method;
 
   bool   m_draw_deads;
+  double m_solve_budget;  // Solve time budget (ms), 0 means none
   
 private:
   XYSegList m_segl;
@@ -80,6 +104,27 @@ private:
   double m_solve_time;
 
   PathField m_pfield;
+
+  // Solve running on a worker thread. While it runs the path field
+  // is not touched from the GUI thread, other than for its
+  // published progress, and anything that would change it first
+  // halts the solve.
+  std::thread       m_solve_thread;
+  bool              m_solving;
+  std::atomic<bool> m_solve_done;
+  MBTimer           m_solve_timer;
+  XYSegList         m_draw_progress;
+
+  // Colored copies for drawing, rebuilt only when the path field
+  // revision changes
+  std::vector<XYPolygon> m_draw_polys;
+  std::vector<XYSegList> m_draw_segls_dead;
+  XYSegList m_draw_shortest;
+  XYSegList m_draw_shortest_port;
+  XYSegList m_draw_shortest_star;
+  XYSegList m_draw_smooth;
+  unsigned int m_draw_revision;
+  bool         m_draw_cache_ok;
 };
 
 #endif 
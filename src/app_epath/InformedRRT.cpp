@@ -0,0 +1,412 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: InformedRRT.cpp                                      */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include "InformedRRT.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+InformedRRT::InformedRRT(const vector<XYPolygon>& polys,
+			 const ObstacleGrid& obs_grid) :
+  m_polys(polys), m_obs_grid(obs_grid)
+{
+  m_sx = 0;
+  m_sy = 0;
+  m_dx = 0;
+  m_dy = 0;
+
+  m_min_x = 0;
+  m_min_y = 0;
+  m_max_x = 0;
+  m_max_y = 0;
+
+  m_leg   = 1;
+  m_gamma = 1;
+  m_best_cost  = -1;
+  m_iterations = 0;
+  m_stop = 0;
+
+  // Init config vars
+  m_step = 0;
+  m_goal_bias = 0.05;
+}
+
+//---------------------------------------------------------------
+// Procedure: plan()
+//   Purpose: Grow the tree from sx,sy toward dx,dy until the time
+//            budget is spent.
+//   Returns: Length of the best path, or -1 if none was found.
+
+double InformedRRT::plan(double sx, double sy, double dx, double dy,
+			 double budget_ms)
+{
+  m_sx = sx;
+  m_sy = sy;
+  m_dx = dx;
+  m_dy = dy;
+
+  m_nx.clear();
+  m_ny.clear();
+  m_cost.clear();
+  m_parent.clear();
+  m_children.clear();
+  m_cells.clear();
+  m_goal_nodes.clear();
+  m_best_path.clear();
+  m_best_cost  = -1;
+  m_iterations = 0;
+
+  double dist_sd = hypot(dx-sx, dy-sy);
+  m_leg = m_step;
+  if(m_leg <= 0)
+    m_leg = dist_sd / 10;
+  if(m_leg <= 0)
+    m_leg = 1;
+
+  // Part 1: Sampling box over the endpoints and obstacles
+  m_min_x = min(sx, dx);
+  m_max_x = max(sx, dx);
+  m_min_y = min(sy, dy);
+  m_max_y = max(sy, dy);
+  for(unsigned int i=0; i<m_polys.size(); i++) {
+    m_min_x = min(m_min_x, m_polys[i].get_min_x());
+    m_max_x = max(m_max_x, m_polys[i].get_max_x());
+    m_min_y = min(m_min_y, m_polys[i].get_min_y());
+    m_max_y = max(m_max_y, m_polys[i].get_max_y());
+  }
+  m_min_x -= m_leg;
+  m_min_y -= m_leg;
+  m_max_x += m_leg;
+  m_max_y += m_leg;
+
+  double area = (m_max_x - m_min_x) * (m_max_y - m_min_y);
+  m_gamma = 2 * sqrt(1.5 * area / M_PI);
+
+  addNode(sx, sy, -1, 0);
+
+  // Part 2: The direct leg, if free, cannot be improved on
+  if(freeSeg(sx, sy, dx, dy)) {
+    m_goal_nodes.push_back(0);
+    updateBest();
+    return(m_best_cost);
+  }
+
+  // Part 3: Grow and rewire until the budget is spent
+  typedef chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+
+  vector<unsigned int> ixs;
+  vector<pair<double, unsigned int> > cands;
+  while(true) {
+    if((m_iterations % 16) == 0) {
+      double elapsed = chrono::duration<double, milli>(Clock::now() - start).count();
+      if(elapsed >= budget_ms)
+	break;
+      if(m_stop && m_stop->load())
+	break;
+    }
+    m_iterations++;
+
+    double px, py;
+    sample(px, py);
+
+    // Steer from the nearest node toward the sample
+    int nix = nearest(px, py);
+    double dist = hypot(px-m_nx[nix], py-m_ny[nix]);
+    if(dist < 1e-9)
+      continue;
+    if(dist > m_leg) {
+      px = m_nx[nix] + (px-m_nx[nix]) * m_leg / dist;
+      py = m_ny[nix] + (py-m_ny[nix]) * m_leg / dist;
+    }
+
+    // No path through this point could beat the best
+    if((m_best_cost >= 0) &&
+       ((hypot(px-sx, py-sy) + hypot(dx-px, dy-py)) >= m_best_cost))
+      continue;
+
+    if(!freeSeg(m_nx[nix], m_ny[nix], px, py))
+      continue;
+
+    // Choose the cheapest free parent among the near nodes
+    double count = (double)(m_nx.size());
+    double rad = min(m_leg, m_gamma * sqrt(log(count+1) / (count+1)));
+    near(px, py, rad, ixs);
+
+    cands.clear();
+    cands.push_back(make_pair(m_cost[nix] + hypot(px-m_nx[nix], py-m_ny[nix]),
+			      (unsigned int)(nix)));
+    for(unsigned int i=0; i<ixs.size(); i++) {
+      if(ixs[i] == (unsigned int)(nix))
+	continue;
+      double c = m_cost[ixs[i]] + hypot(px-m_nx[ixs[i]], py-m_ny[ixs[i]]);
+      cands.push_back(make_pair(c, ixs[i]));
+    }
+    sort(cands.begin(), cands.end());
+
+    unsigned int parent = nix;
+    double cost = cands.back().first;
+    for(unsigned int i=0; i<cands.size(); i++) {
+      unsigned int cix = cands[i].second;
+      if((cix == (unsigned int)(nix)) || freeSeg(m_nx[cix], m_ny[cix], px, py)) {
+	parent = cix;
+	cost = cands[i].first;
+	break;
+      }
+    }
+
+    unsigned int new_ix = addNode(px, py, parent, cost);
+
+    // Rewire the near nodes through the new node where cheaper
+    for(unsigned int i=0; i<ixs.size(); i++) {
+      unsigned int j = ixs[i];
+      if(j == parent)
+	continue;
+      double c = cost + hypot(m_nx[j]-px, m_ny[j]-py);
+      if((c < m_cost[j]) && freeSeg(px, py, m_nx[j], m_ny[j]))
+	setParent(j, new_ix, c);
+    }
+
+    tryGoal(new_ix);
+    if(m_goal_nodes.size() > 0)
+      updateBest();
+  }
+
+  return(m_best_cost);
+}
+
+//---------------------------------------------------------------
+// Procedure: freeSeg()
+
+bool InformedRRT::freeSeg(double x1, double y1, double x2, double y2)
+{
+  m_obs_grid.segCandidates(x1, y1, x2, y2, m_obs_cands);
+  for(unsigned int i=0; i<m_obs_cands.size(); i++) {
+    if(m_polys[m_obs_cands[i]].seg_intercepts(x1, y1, x2, y2))
+      return(false);
+  }
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: sample()
+//      Note: Uniform over the ellipse: a uniform point in the unit
+//            disk, scaled to the semi-axes, rotated to line up
+//            with the source-dest line, and centered between them.
+
+void InformedRRT::sample(double& px, double& py)
+{
+  if(m_best_cost < 0) {
+    if(m_rng.uniform() < m_goal_bias) {
+      px = m_dx;
+      py = m_dy;
+    }
+    else {
+      px = m_rng.uniform(m_min_x, m_max_x);
+      py = m_rng.uniform(m_min_y, m_max_y);
+    }
+    return;
+  }
+
+  double c_min = hypot(m_dx-m_sx, m_dy-m_sy);
+  double c_max = m_best_cost;
+  double semi_a = c_max / 2;
+  double semi_b = sqrt(max(0.0, (c_max*c_max) - (c_min*c_min))) / 2;
+
+  double r = sqrt(m_rng.uniform());
+  double t = m_rng.uniform(0, 2 * M_PI);
+  double ex = semi_a * r * cos(t);
+  double ey = semi_b * r * sin(t);
+
+  double ang = atan2(m_dy-m_sy, m_dx-m_sx);
+  px = ((m_sx+m_dx) / 2) + (ex * cos(ang)) - (ey * sin(ang));
+  py = ((m_sy+m_dy) / 2) + (ex * sin(ang)) + (ey * cos(ang));
+}
+
+//---------------------------------------------------------------
+// Procedure: cellKey()
+
+long long InformedRRT::cellKey(int col, int row) const
+{
+  return(((long long)(col) << 32) | (long long)((unsigned int)(row)));
+}
+
+//---------------------------------------------------------------
+// Procedure: nearest()
+//   Purpose: Find the tree node nearest to px,py by searching the
+//            node grid in rings of cells outward from its cell.
+//      Note: Every cell in ring k+1 is at least k cells away, so
+//            the search stops once the best is within that.
+
+int InformedRRT::nearest(double px, double py) const
+{
+  int col = (int)(floor(px / m_leg));
+  int row = (int)(floor(py / m_leg));
+
+  double far = max(hypot(px-m_min_x, py-m_min_y), hypot(px-m_max_x, py-m_max_y));
+  far = max(far, max(hypot(px-m_min_x, py-m_max_y), hypot(px-m_max_x, py-m_min_y)));
+  int max_ring = (int)(far / m_leg) + 2;
+
+  int    best_ix = 0;
+  double best_dist = hypot(px-m_nx[0], py-m_ny[0]);
+
+  for(int k=0; k<=max_ring; k++) {
+    if((k > 0) && (best_dist <= ((k-1) * m_leg)))
+      break;
+    for(int dc=-k; dc<=k; dc++) {
+      for(int dr=-k; dr<=k; dr++) {
+	if((abs(dc) != k) && (abs(dr) != k))
+	  continue;
+	unordered_map<long long, vector<unsigned int> >::const_iterator p;
+	p = m_cells.find(cellKey(col+dc, row+dr));
+	if(p == m_cells.end())
+	  continue;
+	const vector<unsigned int>& cell = p->second;
+	for(unsigned int i=0; i<cell.size(); i++) {
+	  double dist = hypot(px-m_nx[cell[i]], py-m_ny[cell[i]]);
+	  if(dist < best_dist) {
+	    best_dist = dist;
+	    best_ix = cell[i];
+	  }
+	}
+      }
+    }
+  }
+  return(best_ix);
+}
+
+//---------------------------------------------------------------
+// Procedure: near()
+//   Purpose: Find the tree nodes within rad of px,py. The radius
+//            is never more than the cell size, so the 3x3 block of
+//            cells around px,py covers it.
+
+void InformedRRT::near(double px, double py, double rad,
+		       vector<unsigned int>& ixs) const
+{
+  ixs.clear();
+  int col = (int)(floor(px / m_leg));
+  int row = (int)(floor(py / m_leg));
+
+  for(int dc=-1; dc<=1; dc++) {
+    for(int dr=-1; dr<=1; dr++) {
+      unordered_map<long long, vector<unsigned int> >::const_iterator p;
+      p = m_cells.find(cellKey(col+dc, row+dr));
+      if(p == m_cells.end())
+	continue;
+      const vector<unsigned int>& cell = p->second;
+      for(unsigned int i=0; i<cell.size(); i++) {
+	if(hypot(px-m_nx[cell[i]], py-m_ny[cell[i]]) <= rad)
+	  ixs.push_back(cell[i]);
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: addNode()
+
+unsigned int InformedRRT::addNode(double x, double y, int parent,
+				  double cost)
+{
+  unsigned int ix = m_nx.size();
+  m_nx.push_back(x);
+  m_ny.push_back(y);
+  m_cost.push_back(cost);
+  m_parent.push_back(parent);
+  m_children.push_back(vector<unsigned int>());
+  if(parent >= 0)
+    m_children[parent].push_back(ix);
+
+  int col = (int)(floor(x / m_leg));
+  int row = (int)(floor(y / m_leg));
+  m_cells[cellKey(col, row)].push_back(ix);
+  return(ix);
+}
+
+//---------------------------------------------------------------
+// Procedure: setParent()
+//   Purpose: Move node ix under a new parent at the given cost,
+//            and carry the cost change down to its descendants.
+
+void InformedRRT::setParent(unsigned int ix, unsigned int parent,
+			    double cost)
+{
+  int old_parent = m_parent[ix];
+  if(old_parent >= 0) {
+    vector<unsigned int>& kids = m_children[old_parent];
+    kids.erase(remove(kids.begin(), kids.end(), ix), kids.end());
+  }
+  m_parent[ix] = parent;
+  m_children[parent].push_back(ix);
+
+  double delta = cost - m_cost[ix];
+  vector<unsigned int> stack(1, ix);
+  while(stack.size() > 0) {
+    unsigned int k = stack.back();
+    stack.pop_back();
+    m_cost[k] += delta;
+    for(unsigned int i=0; i<m_children[k].size(); i++)
+      stack.push_back(m_children[k][i]);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: tryGoal()
+
+void InformedRRT::tryGoal(unsigned int ix)
+{
+  double dist = hypot(m_dx-m_nx[ix], m_dy-m_ny[ix]);
+  if(dist > m_leg)
+    return;
+  if(freeSeg(m_nx[ix], m_ny[ix], m_dx, m_dy))
+    m_goal_nodes.push_back(ix);
+}
+
+//---------------------------------------------------------------
+// Procedure: updateBest()
+//   Purpose: Check the goal nodes, whose costs may have dropped by
+//            rewiring, for a path shorter than the best. If found,
+//            rebuild the best path and pass it to the callback.
+
+void InformedRRT::updateBest()
+{
+  int    best_ix = -1;
+  double best_cost = m_best_cost;
+  for(unsigned int i=0; i<m_goal_nodes.size(); i++) {
+    unsigned int ix = m_goal_nodes[i];
+    double cost = m_cost[ix] + hypot(m_dx-m_nx[ix], m_dy-m_ny[ix]);
+    if((best_cost < 0) || (cost < (best_cost - 1e-9))) {
+      best_cost = cost;
+      best_ix = ix;
+    }
+  }
+  if(best_ix < 0)
+    return;
+
+  vector<unsigned int> chain;
+  for(int k=best_ix; k>=0; k=m_parent[k])
+    chain.push_back(k);
+
+  m_best_path.clear();
+  for(unsigned int k=chain.size(); k>0; k--)
+    m_best_path.add_vertex(m_nx[chain[k-1]], m_ny[chain[k-1]]);
+  m_best_path.add_vertex(m_dx, m_dy);
+  m_best_cost = best_cost;
+
+  if(m_callback)
+    m_callback(m_best_path, m_best_cost);
+}
@@ -0,0 +1,116 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: InformedRRT.h                                        */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef INFORMED_RRT_HEADER
+#define INFORMED_RRT_HEADER
+
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include "XYSegList.h"
+#include "XYPolygon.h"
+#include "ObstacleGrid.h"
+#include "RandGen.h"
+
+//---------------------------------------------------------------
+// Anytime informed RRT* over a set of polygon obstacles. A tree
+// rooted at the source is grown by steering toward random samples
+// and rewired so each node keeps its cheapest known parent. Until
+// a first path is found, samples are drawn over the bounding box
+// of the scene, with a small bias toward the destination. After
+// that they are drawn only from the ellipse of points that could
+// still lie on a shorter path (foci at the source and dest, major
+// axis the best path length). The best path only ever improves,
+// and each improvement is handed to the callback as it is found.
+
+class InformedRRT {
+ public:
+  InformedRRT(const std::vector<XYPolygon>&, const ObstacleGrid&);
+  ~InformedRRT() {}
+
+  typedef std::function<void(const XYSegList&, double)> Callback;
+
+  void   setStepSize(double v) {m_step = v;}
+  void   setGoalBias(double v) {m_goal_bias = v;}
+  void   setSeed(uint64_t seed) {m_rng.setSeed(seed);}
+  void   setCallback(Callback cb) {m_callback = cb;}
+  void   setStopFlag(const std::atomic<bool>* flag) {m_stop = flag;}
+
+  double plan(double sx, double sy, double dx, double dy,
+	      double budget_ms);
+
+  const XYSegList& getPath() const {return(m_best_path);}
+  double getPathLen() const        {return(m_best_cost);}
+
+  unsigned int getIterations() const {return(m_iterations);}
+  unsigned int size() const          {return(m_nx.size());}
+
+ protected:
+  bool   freeSeg(double x1, double y1, double x2, double y2);
+  void   sample(double& px, double& py);
+  int    nearest(double px, double py) const;
+  void   near(double px, double py, double rad,
+	      std::vector<unsigned int>& ixs) const;
+  unsigned int addNode(double x, double y, int parent, double cost);
+  void   setParent(unsigned int ix, unsigned int parent, double cost);
+  void   tryGoal(unsigned int ix);
+  void   updateBest();
+  long long cellKey(int col, int row) const;
+
+ protected: // State vars
+  const std::vector<XYPolygon>& m_polys;
+  const ObstacleGrid&           m_obs_grid;
+  std::vector<unsigned int>     m_obs_cands;
+
+  double m_sx;
+  double m_sy;
+  double m_dx;
+  double m_dy;
+
+  // Sampling box for the uninformed phase
+  double m_min_x;
+  double m_min_y;
+  double m_max_x;
+  double m_max_y;
+
+  // The tree
+  std::vector<double> m_nx;
+  std::vector<double> m_ny;
+  std::vector<double> m_cost;
+  std::vector<int>    m_parent;
+  std::vector<std::vector<unsigned int> > m_children;
+
+  // Node grid for neighbor queries, cell size m_step
+  std::unordered_map<long long, std::vector<unsigned int> > m_cells;
+
+  // Nodes with a free leg to the destination
+  std::vector<unsigned int> m_goal_nodes;
+
+  double m_leg;      // Max leg length in use for this plan
+  double m_gamma;    // Scale of the shrinking rewire radius
+
+  XYSegList    m_best_path;
+  double       m_best_cost;
+  unsigned int m_iterations;
+
+  RandGen  m_rng;
+  Callback m_callback;
+
+  // Set by another thread to end the plan early, may be null
+  const std::atomic<bool>* m_stop;
+
+ protected: // Config vars
+  double m_step;       // Max leg length, 0 means 1/10 of src-dest
+  double m_goal_bias;  // Chance of sampling the dest, before a path
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: ObstacleGrid.cpp                                     */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "ObstacleGrid.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+ObstacleGrid::ObstacleGrid()
+{
+  m_cell_size = 25;
+  m_max_cells = 256;
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void ObstacleGrid::clear()
+{
+  m_min_x.clear();
+  m_min_y.clear();
+  m_max_x.clear();
+  m_max_y.clear();
+  m_cells.clear();
+  m_big.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: build()
+//   Purpose: Rebuild the grid over the given obstacles, with the
+//            cell size set to the median of their larger box side,
+//            so a typical obstacle covers only a few cells.
+
+void ObstacleGrid::build(const vector<XYPolygon>& polys)
+{
+  clear();
+
+  vector<double> extents;
+  for(unsigned int i=0; i<polys.size(); i++) {
+    double wid = polys[i].get_max_x() - polys[i].get_min_x();
+    double hgt = polys[i].get_max_y() - polys[i].get_min_y();
+    double ext = max(wid, hgt);
+    if(ext > 0)
+      extents.push_back(ext);
+  }
+  if(extents.size() > 0) {
+    unsigned int mid = extents.size() / 2;
+    nth_element(extents.begin(), extents.begin() + mid, extents.end());
+    setCellSize(extents[mid]);
+  }
+
+  for(unsigned int i=0; i<polys.size(); i++)
+    addPoly(polys[i]);
+}
+
+//---------------------------------------------------------------
+// Procedure: addPoly()
+//   Purpose: Add the next obstacle, entering its index into each
+//            cell overlapped by its bounding box, or onto the big
+//            list if that is more than the max cells.
+
+void ObstacleGrid::addPoly(const XYPolygon& poly)
+{
+  unsigned int ix = m_min_x.size();
+
+  m_min_x.push_back(poly.get_min_x());
+  m_min_y.push_back(poly.get_min_y());
+  m_max_x.push_back(poly.get_max_x());
+  m_max_y.push_back(poly.get_max_y());
+
+  int c1 = cellOf(m_min_x[ix]);
+  int c2 = cellOf(m_max_x[ix]);
+  int r1 = cellOf(m_min_y[ix]);
+  int r2 = cellOf(m_max_y[ix]);
+  double cells = ((double)(c2) - c1 + 1) * ((double)(r2) - r1 + 1);
+  if(cells > m_max_cells) {
+    m_big.push_back(ix);
+    return;
+  }
+  for(int r=r1; r<=r2; r++)
+    for(int c=c1; c<=c2; c++)
+      m_cells[cellKey(c,r)].push_back(ix);
+}
+
+//---------------------------------------------------------------
+// Procedure: cellKey(), cellOf()
+
+long long ObstacleGrid::cellKey(int col, int row) const
+{
+  return(((long long)(col) << 32) | (long long)((unsigned int)(row)));
+}
+
+int ObstacleGrid::cellOf(double v) const
+{
+  return((int)(floor(v / m_cell_size)));
+}
+
+//---------------------------------------------------------------
+// Procedure: addCell()
+//   Purpose: Append the obstacles in the given cell whose bounding
+//            box overlaps the box x1,y1,x2,y2 (min and max corners).
+
+void ObstacleGrid::addCell(int col, int row, double x1, double y1,
+			   double x2, double y2,
+			   vector<unsigned int>& cands) const
+{
+  unordered_map<long long, vector<unsigned int> >::const_iterator p;
+  p = m_cells.find(cellKey(col, row));
+  if(p == m_cells.end())
+    return;
+
+  const vector<unsigned int>& ixs = p->second;
+  for(unsigned int i=0; i<ixs.size(); i++) {
+    unsigned int ix = ixs[i];
+    if((m_max_x[ix] < x1) || (m_min_x[ix] > x2) ||
+       (m_max_y[ix] < y1) || (m_min_y[ix] > y2))
+      continue;
+    cands.push_back(ix);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: addBig()
+//   Purpose: Append the big-list obstacles whose bounding box
+//            overlaps the box x1,y1,x2,y2 (min and max corners).
+
+void ObstacleGrid::addBig(double x1, double y1, double x2, double y2,
+			  vector<unsigned int>& cands) const
+{
+  for(unsigned int i=0; i<m_big.size(); i++) {
+    unsigned int ix = m_big[i];
+    if((m_max_x[ix] < x1) || (m_min_x[ix] > x2) ||
+       (m_max_y[ix] < y1) || (m_min_y[ix] > y2))
+      continue;
+    cands.push_back(ix);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: segCandidates()
+//   Purpose: Fill cands with the obstacles possibly intersecting
+//            the segment, each listed once, in increasing order.
+//      Note: The walk steps one cell per iteration toward the end
+//            cell, along whichever axis the segment crosses next.
+//            Once either axis reaches the end cell only the other
+//            axis steps, so the walk always ends in the end cell.
+
+void ObstacleGrid::segCandidates(double x1, double y1,
+				 double x2, double y2,
+				 vector<unsigned int>& cands) const
+{
+  cands.clear();
+  if(m_min_x.size() == 0)
+    return;
+
+  double bx1 = min(x1, x2);
+  double by1 = min(y1, y2);
+  double bx2 = max(x1, x2);
+  double by2 = max(y1, y2);
+
+  int col  = cellOf(x1);
+  int row  = cellOf(y1);
+  int ecol = cellOf(x2);
+  int erow = cellOf(y2);
+
+  double dx = x2 - x1;
+  double dy = y2 - y1;
+  double inf = 1e300;
+
+  int    step_c = (dx > 0) ? 1 : -1;
+  int    step_r = (dy > 0) ? 1 : -1;
+  double tdelta_c = (dx != 0) ? (m_cell_size / fabs(dx)) : inf;
+  double tdelta_r = (dy != 0) ? (m_cell_size / fabs(dy)) : inf;
+
+  double tnext_c = inf;
+  if(dx > 0)
+    tnext_c = ((col+1)*m_cell_size - x1) / dx;
+  else if(dx < 0)
+    tnext_c = (col*m_cell_size - x1) / dx;
+
+  double tnext_r = inf;
+  if(dy > 0)
+    tnext_r = ((row+1)*m_cell_size - y1) / dy;
+  else if(dy < 0)
+    tnext_r = (row*m_cell_size - y1) / dy;
+
+  unsigned int steps = abs(ecol - col) + abs(erow - row);
+  addCell(col, row, bx1, by1, bx2, by2, cands);
+  for(unsigned int k=0; k<steps; k++) {
+    bool step_col = (tnext_c < tnext_r);
+    if(col == ecol)
+      step_col = false;
+    else if(row == erow)
+      step_col = true;
+
+    // Passing exactly through a cell corner touches both cells
+    if(fabs(tnext_c - tnext_r) < 1e-12) {
+      if(step_col)
+	addCell(col, row+step_r, bx1, by1, bx2, by2, cands);
+      else
+	addCell(col+step_c, row, bx1, by1, bx2, by2, cands);
+    }
+
+    if(step_col) {
+      col += step_c;
+      tnext_c += tdelta_c;
+    }
+    else {
+      row += step_r;
+      tnext_r += tdelta_r;
+    }
+    addCell(col, row, bx1, by1, bx2, by2, cands);
+  }
+  addBig(bx1, by1, bx2, by2, cands);
+
+  sort(cands.begin(), cands.end());
+  cands.erase(unique(cands.begin(), cands.end()), cands.end());
+}
+
+//---------------------------------------------------------------
+// Procedure: ptCandidates()
+//   Purpose: Fill cands with the obstacles whose bounding box
+//            contains the given point.
+
+void ObstacleGrid::ptCandidates(double px, double py,
+				vector<unsigned int>& cands) const
+{
+  cands.clear();
+  addCell(cellOf(px), cellOf(py), px, py, px, py, cands);
+  addBig(px, py, px, py, cands);
+}
@@ -0,0 +1,79 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: ObstacleGrid.h                                       */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef OBSTACLE_GRID_HEADER
+#define OBSTACLE_GRID_HEADER
+
+#include <vector>
+#include <unordered_map>
+#include "XYPolygon.h"
+
+//---------------------------------------------------------------
+// A sparse uniform grid over the bounding boxes of a set of
+// polygon obstacles, indexed by their position in the caller's
+// obstacle vector. Obstacles are added one at a time, so the grid
+// has no fixed extent. Segment queries walk only the cells the
+// segment crosses (2D DDA) and return the obstacles whose box
+// overlaps the segment's box, so only nearby obstacles need the
+// exact intersection test. An obstacle whose box would cover more
+// than the max cells is kept on a list tested by every query
+// instead, so one huge piece, e.g., of a shoreline, can't fill
+// the map. Built all at once, the cell size is set from the
+// median obstacle extent.
+
+class ObstacleGrid {
+ public:
+  ObstacleGrid();
+  ~ObstacleGrid() {}
+
+  void   setCellSize(double v) {if(v > 0) m_cell_size = v;}
+  void   setMaxCells(unsigned int v) {if(v > 0) m_max_cells = v;}
+  void   build(const std::vector<XYPolygon>&);
+  void   addPoly(const XYPolygon&);
+  void   clear();
+
+  void   segCandidates(double x1, double y1, double x2, double y2,
+		       std::vector<unsigned int>& cands) const;
+  void   ptCandidates(double px, double py,
+		      std::vector<unsigned int>& cands) const;
+
+  unsigned int size() const      {return(m_min_x.size());}
+  unsigned int cellCount() const {return(m_cells.size());}
+  unsigned int bigCount() const  {return(m_big.size());}
+  double       getCellSize() const {return(m_cell_size);}
+
+ protected:
+  long long cellKey(int col, int row) const;
+  int       cellOf(double v) const;
+
+  void   addCell(int col, int row, double x1, double y1,
+		 double x2, double y2,
+		 std::vector<unsigned int>& cands) const;
+  void   addBig(double x1, double y1, double x2, double y2,
+		std::vector<unsigned int>& cands) const;
+
+ protected: // State vars
+  std::vector<double> m_min_x;
+  std::vector<double> m_min_y;
+  std::vector<double> m_max_x;
+  std::vector<double> m_max_y;
+
+  std::unordered_map<long long, std::vector<unsigned int> > m_cells;
+
+  // Obstacles too big to enter cell by cell
+  std::vector<unsigned int> m_big;
+
+ protected: // Config vars
+  double       m_cell_size;
+  unsigned int m_max_cells;
+};
+
+#endif
@@ -10,7 +10,15 @@
 /*****************************************************************/
 
 #include <cmath>
+#include <thread>
+#include <random>
+#include <functional>
+#include <algorithm>
 #include "PathField.h"
+#include "InformedRRT.h"
+#include "CoverEngine.h"
+#include "PolyUnion.h"
+#include "ConvexHullGenerator.h"
 #include "MBUtils.h"
 #include "GeomUtils.h"
 #include "AngleUtils.h"
@@ -34,8 +42,51 @@ PathField::PathField()
   m_dist_shortest_star = -1; // -1 means no path found yet.
   m_dist_shortest_port = -1; // -1 means no path found yet.
 
+  m_revision = 0;
+  m_vgraph_ok = false;
+  m_many_tree_ms = 0;
+  m_coll_tests = 0;
+
+  m_bound_shortest = -1;
+  m_bound_port = -1;
+  m_bound_star = -1;
+
+  m_deadline_on = false;
+  m_budget_ms = 0;
+  m_stop = false;
+  m_progress_dist = -1;
+  m_progress_count = 0;
+
+  m_focus_ok = false;
+  m_focus_port_x = 0;
+  m_focus_port_y = 0;
+  m_focus_port = 0;
+  m_focus_star_x = 0;
+  m_focus_star_y = 0;
+  m_focus_star = 0;
+
+  m_pref_port = 0;
+  m_pref_star = 0;
+  m_pref_ok = 0;
+  m_need_port = 0;
+  m_need_star = 0;
+
   // Init config vars
   m_branches   = 30;
+  m_threads    = 1;
+  m_seed       = random_device()();
+  m_run_count  = 0;
+  m_solve_mode = "random";
+  m_search_order = "depth";
+  m_beam_width   = 10;
+  m_node_budget  = 20000;
+  m_rrt_budget = 250;
+  m_warm_start = false;
+  m_clearance  = 0;
+  m_arc_tol    = 0.5;
+  m_merge_gap  = 0;
+  m_merge_hulls = false;
+  m_notch_depth = 5;
   m_focus_poly = -1;
 }
 
@@ -48,225 +99,2049 @@ void PathField::addPoly(XYPolygon poly)
     string label = "p" + uintToString(m_polys.size());
     poly.set_label(label);
   }
-  m_polys.push_back(poly);
-  clearSolve();
+
+  // A non-convex poly is handled as a genpoly, by its cover pieces
+  if(!poly.is_convex() && (poly.size() >= 3)) {
+    XYSegList border;
+    for(unsigned int i=0; i<poly.size(); i++)
+      border.add_vertex(poly.get_vx(i), poly.get_vy(i));
+    CoverEngine engine;
+    engine.setPoints(border);
+    addGenPoly(engine.getGenPoly(), poly.get_label());
+    return;
+  }
+
+  addOutline(poly, vector<XYPolygon>(1, poly));
+}
+
+//---------------------------------------------------------------
+// Procedure: addGenPoly()
+//   Purpose: Add a non-convex obstacle. Collision checks are made
+//            against its convex cover pieces, through the obstacle
+//            grid, and the border is kept as its outline. If the
+//            genpoly has no cover yet, one is solved for here.
+
+void PathField::addGenPoly(const XYGenPolygon& gpoly, string label)
+{
+  XYSegList border = gpoly.getSegList();
+  if(border.size() < 3)
+    return;
+
+  vector<XYPolygon> pieces = gpoly.getCoverPolys();
+  if(pieces.size() == 0) {
+    CoverEngine engine;
+    engine.setPoints(border);
+    pieces = engine.getGenPoly().getCoverPolys();
+  }
+  if(pieces.size() == 0)
+    return;
+
+  XYPolygon outline;
+  for(unsigned int i=0; i<border.size(); i++)
+    outline.add_vertex(border.get_vx(i), border.get_vy(i));
+  if(label == "")
+    label = "p" + uintToString(m_polys.size());
+  outline.set_label(label);
+
+  addOutline(outline, pieces);
+}
+
+//---------------------------------------------------------------
+// Procedure: addOutline()
+//   Purpose: Add an obstacle given its outline and the convex
+//            pieces it is made of.
+
+void PathField::addOutline(const XYPolygon& outline,
+			   const vector<XYPolygon>& pieces)
+{
+  if(pieces.size() == 0)
+    return;
+
+  // Side rays are aimed from the center of the largest piece. If
+  // not inside the outline, e.g., a piece poking out of a merged
+  // hull, the side of the poly can't be judged
+  unsigned int big = 0;
+  for(unsigned int i=1; i<pieces.size(); i++) {
+    if(pieces[i].area() > pieces[big].area())
+      big = i;
+  }
+  double ax = pieces[big].get_center_x();
+  double ay = pieces[big].get_center_y();
+  m_anchor_x.push_back(ax);
+  m_anchor_y.push_back(ay);
+  m_anchor_ok.push_back(outline.contains(ax, ay));
+
+  m_polys.push_back(outline);
+  for(unsigned int i=0; i<pieces.size(); i++)
+    addPiece(pieces[i], m_polys.size()-1);
+  m_vgraph_ok = false;
+  clearSolve();
+}
+
+//---------------------------------------------------------------
+// Procedure: mergeObstacles()
+//   Purpose: Merge obstacles that overlap, touch, or are closer
+//            than the merge gap, so that fewer, larger obstacles
+//            are searched and no passage narrower than the gap is
+//            tried. A group whose pieces form one connected shape
+//            becomes that shape, outlined and covered again. A
+//            group held together only across gaps has no such
+//            shape, and each outline of its union becomes its own
+//            obstacle. With merge hulls on, such a group becomes
+//            its convex hull instead, unless the hull would hold
+//            the source or dest. Notches shallower than the notch
+//            depth, as left where shapes overlap, are filled
+//            first, so the outline has few vertices and few cover
+//            pieces. A notch holding the source or dest is kept.
+//            A group enclosing the source or dest in a hole of its
+//            union is not merged at all, as the hole would be
+//            dropped with the point inside it.
+//      Note: Obstacle indices change, so the focus poly and side
+//            preferences are cleared.
+//      Note: The source and dest are those set when merging. A
+//            later move into a hull or filled notch is not undone.
+//   Returns: The number of obstacles removed by merging.
+
+unsigned int PathField::mergeObstacles()
+{
+  unsigned int osize = m_polys.size();
+  if(osize < 2)
+    return(0);
+
+  // Part 1: Group obstacles, union-find over obstacle indices
+  vector<unsigned int> group(osize);
+  for(unsigned int i=0; i<osize; i++)
+    group[i] = i;
+
+  for(unsigned int i=0; i<m_raw_pieces.size(); i++) {
+    for(unsigned int j=i+1; j<m_raw_pieces.size(); j++) {
+      unsigned int gi = m_piece_owner[i];
+      while(group[gi] != gi)
+	gi = group[gi];
+      unsigned int gj = m_piece_owner[j];
+      while(group[gj] != gj)
+	gj = group[gj];
+      if(gi == gj)
+	continue;
+      if(piecesNear(m_raw_pieces[i], m_raw_pieces[j], m_merge_gap))
+	group[max(gi,gj)] = min(gi,gj);
+    }
+  }
+  for(unsigned int i=0; i<osize; i++) {
+    while(group[group[i]] != group[i])
+      group[i] = group[group[i]];
+  }
+
+  // Part 2: Build the new obstacle set, outline and pieces
+  vector<XYPolygon> new_outlines;
+  vector<vector<XYPolygon> > new_pieces;
+  for(unsigned int g=0; g<osize; g++) {
+    vector<unsigned int> members;
+    for(unsigned int i=0; i<osize; i++) {
+      if(group[i] == g)
+	members.push_back(i);
+    }
+    if(members.size() == 0)
+      continue;
+
+    vector<XYPolygon> pieces;
+    for(unsigned int i=0; i<m_raw_pieces.size(); i++) {
+      if(group[m_piece_owner[i]] == g)
+	pieces.push_back(m_raw_pieces[i]);
+    }
+    if(members.size() == 1) {
+      new_outlines.push_back(m_polys[members[0]]);
+      new_pieces.push_back(pieces);
+      continue;
+    }
+
+    PolyUnion poly_union;
+    poly_union.addKeepPoint(m_sx, m_sy);
+    poly_union.addKeepPoint(m_dx, m_dy);
+    for(unsigned int i=0; i<pieces.size(); i++)
+      poly_union.addPoly(pieces[i]);
+    vector<XYPolygon> outlines = poly_union.getOutlines();
+    bool keep_members = (poly_union.getKeptHoles() > 0);
+
+    // The hull, if enabled and clear of the endpoints, is used
+    // where the union has no one outline
+    XYPolygon hull;
+    bool hull_ok = false;
+    if(m_merge_hulls && !keep_members) {
+      ConvexHullGenerator generator;
+      for(unsigned int i=0; i<pieces.size(); i++) {
+	for(unsigned int j=0; j<pieces[i].size(); j++)
+	  generator.addPoint(pieces[i].get_point(j));
+      }
+      hull = generator.generateConvexHull();
+      hull_ok = (hull.size() >= 3) && !holdsEndpoint(hull);
+    }
+    bool use_hull = hull_ok && (outlines.size() != 1);
+
+    // Otherwise each union outline, notches filled, is an obstacle
+    vector<XYPolygon> outs;
+    vector<vector<XYPolygon> > covers;
+    bool covered = !use_hull && !keep_members && (outlines.size() > 0);
+    for(unsigned int i=0; (i<outlines.size()) && covered; i++) {
+      XYPolygon outline = poly_union.fillNotches(outlines[i], m_notch_depth);
+      vector<XYPolygon> cover;
+      covered = coverOutline(outline, cover);
+      outs.push_back(outline);
+      covers.push_back(cover);
+    }
+
+    if(!covered && hull_ok) {
+      outs = vector<XYPolygon>(1, hull);
+      covers = vector<vector<XYPolygon> >(1, outs);
+      covered = true;
+    }
+
+    // Failing all else the members are kept as they were
+    if(!covered) {
+      for(unsigned int i=0; i<members.size(); i++) {
+	vector<XYPolygon> member_pieces;
+	for(unsigned int j=0; j<m_raw_pieces.size(); j++) {
+	  if(m_piece_owner[j] == members[i])
+	    member_pieces.push_back(m_raw_pieces[j]);
+	}
+	new_outlines.push_back(m_polys[members[i]]);
+	new_pieces.push_back(member_pieces);
+      }
+      continue;
+    }
+
+    for(unsigned int i=0; i<outs.size(); i++) {
+      outs[i].set_label(m_polys[members[0]].get_label());
+      new_outlines.push_back(outs[i]);
+      new_pieces.push_back(covers[i]);
+    }
+  }
+
+  // Part 3: Replace the obstacles
+  clearPolys();
+  m_focus_poly = -1;
+  for(unsigned int i=0; i<new_outlines.size(); i++)
+    addOutline(new_outlines[i], new_pieces[i]);
+  m_obs_grid.build(m_pieces);
+
+  if(m_polys.size() >= osize)
+    return(0);
+  return(osize - m_polys.size());
+}
+
+//---------------------------------------------------------------
+// Procedure: coverOutline()
+//   Purpose: Cover a merged outline with convex pieces, the outline
+//            itself if convex.
+//   Returns: false if no cover was found.
+
+bool PathField::coverOutline(const XYPolygon& outline,
+			     vector<XYPolygon>& cover) const
+{
+  cover.clear();
+  if(outline.size() < 3)
+    return(false);
+
+  if(outline.is_convex()) {
+    cover.push_back(outline);
+    return(true);
+  }
+
+  XYSegList border;
+  for(unsigned int i=0; i<outline.size(); i++)
+    border.add_vertex(outline.get_vx(i), outline.get_vy(i));
+  CoverEngine engine;
+  engine.setPoints(border);
+  cover = engine.getGenPoly().getCoverPolys();
+  return(cover.size() > 0);
+}
+
+//---------------------------------------------------------------
+// Procedure: holdsEndpoint()
+//   Purpose: Determine if a merged shape would hold the source or
+//            the destination, making the path search fail.
+
+bool PathField::holdsEndpoint(const XYPolygon& poly) const
+{
+  return(poly.contains(m_sx, m_sy) || poly.contains(m_dx, m_dy));
+}
+
+//---------------------------------------------------------------
+// Procedure: piecesNear()
+//   Purpose: Determine if two convex pieces overlap, touch, or are
+//            no more than the given gap apart.
+
+bool PathField::piecesNear(const XYPolygon& poly1, const XYPolygon& poly2,
+			   double gap) const
+{
+  if((poly1.size() == 0) || (poly2.size() == 0))
+    return(false);
+
+  // Quick rejection on the bounding boxes
+  if((poly1.get_min_x() > (poly2.get_max_x() + gap)) ||
+     (poly2.get_min_x() > (poly1.get_max_x() + gap)) ||
+     (poly1.get_min_y() > (poly2.get_max_y() + gap)) ||
+     (poly2.get_min_y() > (poly1.get_max_y() + gap)))
+    return(false);
+
+  for(unsigned int i=0; i<poly1.size(); i++) {
+    unsigned int j = (i+1) % poly1.size();
+    double x1 = poly1.get_vx(i);
+    double y1 = poly1.get_vy(i);
+    double x2 = poly1.get_vx(j);
+    double y2 = poly1.get_vy(j);
+    if(poly2.seg_intercepts(x1,y1, x2,y2))
+      return(true);
+    if(poly2.dist_to_poly(x1,y1, x2,y2) <= (gap + 1e-6))
+      return(true);
+  }
+  // The only case left is poly2 wholly inside poly1
+  return(poly1.contains(poly2.get_vx(0), poly2.get_vy(0)));
+}
+
+//---------------------------------------------------------------
+// Procedure: addPiece()
+
+void PathField::addPiece(const XYPolygon& piece, unsigned int owner)
+{
+  m_raw_pieces.push_back(piece);
+  m_pieces.push_back(inflatePiece(piece));
+  m_piece_owner.push_back(owner);
+  m_obs_grid.addPoly(m_pieces.back());
+}
+
+//---------------------------------------------------------------
+// Procedure: setClearance()
+//   Purpose: Set the clearance kept from all obstacles, e.g., the
+//            vehicle radius. Pieces are re-inflated once here, not
+//            on each query.
+
+void PathField::setClearance(double clearance)
+{
+  if(clearance < 0)
+    clearance = 0;
+  if(clearance == m_clearance)
+    return;
+  m_clearance = clearance;
+  reinflate();
+}
+
+//---------------------------------------------------------------
+// Procedure: setArcTol()
+//   Purpose: Set the most an inflated corner may stand off the true
+//            clearance arc. Smaller means more piece vertices.
+
+void PathField::setArcTol(double tol)
+{
+  if((tol <= 0) || (tol == m_arc_tol))
+    return;
+  m_arc_tol = tol;
+  if(m_clearance > 0)
+    reinflate();
+}
+
+//---------------------------------------------------------------
+// Procedure: reinflate()
+//      Note: The obstacle grid is rebuilt whole, so its cells are
+//            sized to the inflated pieces.
+
+void PathField::reinflate()
+{
+  for(unsigned int i=0; i<m_raw_pieces.size(); i++)
+    m_pieces[i] = inflatePiece(m_raw_pieces[i]);
+  m_obs_grid.build(m_pieces);
+  m_vgraph_ok = false;
+  clearSolve();
+}
+
+//---------------------------------------------------------------
+// Procedure: inflatePiece()
+//   Purpose: Grow a convex piece by the clearance, i.e., its
+//            Minkowski sum with a disk. Each corner arc is replaced
+//            by a fan of vertices whose edges are tangent to the
+//            arc, so the result contains the true offset shape and
+//            stands off it by at most the arc tolerance.
+//      Note: Edges of the offset shape lie on the piece edges
+//            pushed out by the clearance. They pass through the
+//            first and last fan vertex of each corner, so no other
+//            vertices are needed.
+
+XYPolygon PathField::inflatePiece(const XYPolygon& piece) const
+{
+  unsigned int vsize = piece.size();
+  if((m_clearance <= 0) || (vsize < 3))
+    return(piece);
+
+  // Work in counter-clockwise order, outward normals to the right
+  vector<double> vx(vsize), vy(vsize);
+  double area2 = 0;
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int j = (i+1) % vsize;
+    area2 += piece.get_vx(i) * piece.get_vy(j);
+    area2 -= piece.get_vx(j) * piece.get_vy(i);
+  }
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int k = (area2 > 0) ? i : (vsize-1-i);
+    vx[i] = piece.get_vx(k);
+    vy[i] = piece.get_vy(k);
+  }
+
+  // Largest fan step keeping the corners within the arc tolerance
+  double rad = m_clearance;
+  double max_step = 2 * acos(rad / (rad + m_arc_tol));
+
+  XYPolygon inflated;
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int h = (i+vsize-1) % vsize;
+    unsigned int j = (i+1) % vsize;
+    double ang1 = atan2(-(vx[i]-vx[h]), vy[i]-vy[h]);
+    double ang2 = atan2(-(vx[j]-vx[i]), vy[j]-vy[i]);
+    double sweep = ang2 - ang1;
+    while(sweep < 0)
+      sweep += 2 * M_PI;
+    while(sweep >= 2 * M_PI)
+      sweep -= 2 * M_PI;
+
+    // Collinear or repeated vertex: no corner to round
+    if(sweep < 1e-9)
+      continue;
+
+    unsigned int steps = (unsigned int)(ceil(sweep / max_step));
+    if(steps == 0)
+      steps = 1;
+    double step = sweep / steps;
+    double dist = rad / cos(step / 2);
+    for(unsigned int k=0; k<steps; k++) {
+      double ang = ang1 + step * (k + 0.5);
+      inflated.add_vertex(vx[i] + dist * cos(ang),
+			  vy[i] + dist * sin(ang), false);
+    }
+  }
+  inflated.determine_convexity();
+  inflated.set_label(piece.get_label());
+  return(inflated);
+}
+
+//---------------------------------------------------------------
+// Procedure: polyAt()
+//   Purpose: Find the obstacle containing x,y, judged by its convex
+//            pieces. If more than one does, the one whose edge is
+//            nearest is taken.
+//   Returns: Index of the obstacle, or -1 if none.
+
+int PathField::polyAt(double x, double y) const
+{
+  int    poly_ix = -1;
+  double closest_dist = -1;
+
+  vector<unsigned int> cands;
+  m_obs_grid.ptCandidates(x, y, cands);
+  for(unsigned int i=0; i<cands.size(); i++) {
+    const XYPolygon& piece = m_pieces[cands[i]];
+    if(!piece.contains(x,y))
+      continue;
+    double dist = piece.dist_to_poly(x,y);
+    if((closest_dist < 0) || (dist < closest_dist)) {
+      poly_ix = m_piece_owner[cands[i]];
+      closest_dist = dist;
+    }
+  }
+  return(poly_ix);
+}
+
+//---------------------------------------------------------------
+// Procedure: clearPolys()
+
+void PathField::clearPolys()
+{
+  m_polys.clear();
+  m_pieces.clear();
+  m_raw_pieces.clear();
+  m_piece_owner.clear();
+  m_anchor_x.clear();
+  m_anchor_y.clear();
+  m_anchor_ok.clear();
+  clearSidePrefs();
+  m_obs_grid.clear();
+  m_vgraph.clear();
+  m_vgraph_ok = false;
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: focusPoly()
+
+void PathField::focusPoly(int ix)
+{
+  if(ix < 0) {
+    m_focus_poly = -1;
+    m_revision++;
+    return;
+  }
+    
+  if((unsigned int)(ix) >= m_polys.size())
+    return;
+
+  m_focus_poly = ix;
+  clearSolve();
+}
+
+
+//---------------------------------------------------------------
+// Procedure: focusPolyOff()
+
+void PathField::focusPolyOff()
+{
+  m_focus_poly = -1;
+  clearSolve();
+}
+
+
+//---------------------------------------------------------------
+// Procedure: focusPoly()
+
+void PathField::focusPoly(double vx, double vy)
+{
+  int focus_poly = polyAt(vx, vy);
+
+  // If prior focus poly is selected, treat this as disabel request
+  if(focus_poly == m_focus_poly)
+    m_focus_poly = -1;
+  else if(focus_poly >= 0)
+    m_focus_poly = focus_poly;
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: clearSolve()
+
+void PathField::clearSolve()
+{
+  m_dead_sink.clear();
+  m_segl_shortest.clear();
+  m_dist_shortest = -1;
+
+  m_segl_shortest_port.clear();
+  m_dist_shortest_port = -1;
+
+  m_segl_shortest_star.clear();
+  m_dist_shortest_star = -1;
+
+  m_segl_smooth.clear();
+  resetProgress();
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: setSource()
+
+void PathField::setSource(double x, double y)
+{
+  if((x != m_sx) || (y != m_sy))
+    resetProgress();
+  m_sx = x;
+  m_sy = y;
+}
+
+//---------------------------------------------------------------
+// Procedure: setDest()
+
+void PathField::setDest(double x, double y)
+{
+  if((x != m_dx) || (y != m_dy))
+    resetProgress();
+  m_dx = x;
+  m_dy = y;
+}
+
+//---------------------------------------------------------------
+// Procedure: moveSource()
+//   Purpose: Move the source. With warm start on, the last paths
+//            are repaired to the new source rather than dropped,
+//            so the next solve starts with their lengths as its
+//            bounds and searches only for improvements.
+
+void PathField::moveSource(double x, double y)
+{
+  resetProgress();
+  m_sx = x;
+  m_sy = y;
+  if(m_warm_start)
+    warmStart(true);
+  else
+    clearSolve();
+}
+
+//---------------------------------------------------------------
+// Procedure: moveDest()
+
+void PathField::moveDest(double x, double y)
+{
+  resetProgress();
+  m_dx = x;
+  m_dy = y;
+  if(m_warm_start)
+    warmStart(false);
+  else
+    clearSolve();
+}
+
+//---------------------------------------------------------------
+// Procedure: warmStart()
+//   Purpose: Repair the shortest paths after the source (or dest)
+//            has moved. Paths that cannot be repaired, or that no
+//            longer pass the focus poly on their side, are dropped.
+
+void PathField::warmStart(bool src_moved)
+{
+  PathSearchState st;
+  st.coll_tests = 0;
+
+  m_dead_sink.clear();
+  m_dist_shortest = repairSegl(st, m_segl_shortest, src_moved);
+
+  // The side rays are set from the source, so are reset here to
+  // recheck the repaired path against the side preferences
+  setSideRays();
+  if((m_dist_shortest >= 0) && m_pref_ok) {
+    uint64_t xport, xstar;
+    seglSignature(m_segl_shortest, xport, xstar);
+    if(!sideMet(xport, xstar)) {
+      m_segl_shortest.clear();
+      m_dist_shortest = -1;
+    }
+  }
+
+  if(m_focus_poly >= 0) {
+    m_dist_shortest_port = repairSegl(st, m_segl_shortest_port, src_moved);
+    if((m_dist_shortest_port >= 0) &&
+       (seglPassPoly(m_focus_poly, m_segl_shortest_port) != "port")) {
+      m_segl_shortest_port.clear();
+      m_dist_shortest_port = -1;
+    }
+    m_dist_shortest_star = repairSegl(st, m_segl_shortest_star, src_moved);
+    if((m_dist_shortest_star >= 0) &&
+       (seglPassPoly(m_focus_poly, m_segl_shortest_star) != "star")) {
+      m_segl_shortest_star.clear();
+      m_dist_shortest_star = -1;
+    }
+  }
+  smoothShortest();
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: repairSegl()
+//   Purpose: Reconnect a path to its moved end. The path past the
+//            moved end is known to be free, so it is trimmed to
+//            the vertex giving the shortest path of those with a
+//            free leg from the new end point, then simplified.
+//   Returns: Length of the repaired path, or -1 if it could not be
+//            repaired, in which case it is cleared.
+
+double PathField::repairSegl(PathSearchState& st, XYSegList& segl,
+			     bool src_moved) const
+{
+  unsigned int vsize = segl.size();
+  if(vsize < 2) {
+    segl.clear();
+    return(-1);
+  }
+
+  // Vertices ordered from the moved end, and the path length from
+  // each to the fixed end
+  vector<double> vx(vsize), vy(vsize), tail(vsize, 0);
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int j = src_moved ? i : (vsize-1-i);
+    vx[i] = segl.get_vx(j);
+    vy[i] = segl.get_vy(j);
+  }
+  for(unsigned int i=vsize-1; i>0; i--)
+    tail[i-1] = tail[i] + hypot(vx[i]-vx[i-1], vy[i]-vy[i-1]);
+
+  double px = src_moved ? m_sx : m_dx;
+  double py = src_moved ? m_sy : m_dy;
+
+  // Try the reconnections cheapest first, the first free one wins
+  vector<pair<double, unsigned int> > cands;
+  for(unsigned int i=1; i<vsize; i++)
+    cands.push_back(make_pair(hypot(vx[i]-px, vy[i]-py) + tail[i], i));
+  sort(cands.begin(), cands.end());
+
+  int ix = -1;
+  for(unsigned int i=0; (i<cands.size()) && (ix < 0); i++) {
+    unsigned int k = cands[i].second;
+    if(freeSeg(st, px,py, vx[k],vy[k]))
+      ix = k;
+  }
+  if(ix < 0) {
+    segl.clear();
+    return(-1);
+  }
+
+  XYSegList new_segl;
+  if(src_moved) {
+    new_segl.add_vertex(px, py);
+    for(unsigned int i=ix; i<vsize; i++)
+      new_segl.add_vertex(vx[i], vy[i]);
+  }
+  else {
+    for(unsigned int i=vsize-1; i>=(unsigned int)(ix); i--)
+      new_segl.add_vertex(vx[i], vy[i]);
+    new_segl.add_vertex(px, py);
+  }
+
+  segl = simplifySegl(st, new_segl);
+  return(segl.length());
+}
+
+//---------------------------------------------------------------
+// Procedure: solve()
+//   Purpose: Search for the shortest path. Given a budget (ms) the
+//            search winds up once it is spent and keeps the best
+//            found so far. Each improved path is published as it
+//            is found, see getProgress(), so a caller on another
+//            thread can show the search as it refines.
+//      Note: To run the search on a worker thread, the caller
+//            should instead call prepareSolve() on its own thread
+//            and then runSolve() on the worker, so that a stop()
+//            made before the worker gets going is not lost.
+
+void PathField::solve(double budget_ms)
+{
+  prepareSolve(budget_ms);
+  runSolve();
+}
+
+//---------------------------------------------------------------
+// Procedure: prepareSolve()
+//   Purpose: Clear the stop flag, set the deadline, and seed the
+//            published progress with the path held from before,
+//            if it joins the current source and dest.
+//            Called on the caller's thread, before any worker.
+
+void PathField::prepareSolve(double budget_ms)
+{
+  m_stop = false;
+  m_budget_ms = budget_ms;
+  m_deadline_on = (budget_ms > 0);
+  if(m_deadline_on) {
+    chrono::duration<double, milli> budget(budget_ms);
+    m_deadline = chrono::steady_clock::now() +
+      chrono::duration_cast<chrono::steady_clock::duration>(budget);
+  }
+
+  resetProgress();
+  unsigned int vsize = m_segl_shortest.size();
+  if((m_dist_shortest < 0) || (vsize < 2))
+    return;
+  if((m_segl_shortest.get_vx(0) != m_sx) ||
+     (m_segl_shortest.get_vy(0) != m_sy) ||
+     (m_segl_shortest.get_vx(vsize-1) != m_dx) ||
+     (m_segl_shortest.get_vy(vsize-1) != m_dy))
+    return;
+
+  lock_guard<mutex> lock(m_progress_mutex);
+  m_progress_segl = m_segl_shortest;
+  m_progress_dist = m_dist_shortest;
+}
+
+//---------------------------------------------------------------
+// Procedure: runSolve()
+//   Purpose: Run the search set up by prepareSolve().
+//      Note: With more than one thread the top-level branches are
+//            shared out over a pool of workers. Each has its own
+//            search state, and all prune against the shared best
+//            distances. Results are merged when all are done.
+//      Note: The visibility graph path is exact, so it replaces
+//            whatever was published before rather than competing
+//            with it.
+
+void PathField::runSolve()
+{
+  m_dead_sink.clear();
+
+  if(m_solve_mode == "vgraph") {
+    solveVGraph();
+    resetProgress();
+    publish(m_segl_shortest, m_dist_shortest);
+    smoothShortest();
+    m_revision++;
+    return;
+  }
+
+  // Each run draws from its own seed, derived from the PathField
+  // seed and the run number, and reported as the run ID.
+  uint64_t run_seed = ((uint64_t)(m_seed) << 32) | m_run_count;
+  m_run_id = uintToString(m_seed) + "." + uintToString(m_run_count);
+  m_run_count++;
+
+  if(m_solve_mode == "rrt") {
+    solveRRT(run_seed, (m_budget_ms > 0) ? m_budget_ms : m_rrt_budget);
+    smoothShortest();
+    m_revision++;
+    return;
+  }
+
+  m_coll_tests = 0;
+  setFocusRays();
+  setSideRays();
+  m_bound_shortest = m_dist_shortest;
+  m_bound_port = m_dist_shortest_port;
+  m_bound_star = m_dist_shortest_star;
+
+  if(m_search_order != "depth") {
+    PathSearchState st;
+    initState(st, run_seed);
+    if(m_focus_poly < 0)
+      solveTree(st, -1);
+    else {
+      solveTree(st, 0);
+      solveTree(st, 1);
+    }
+    mergeState(st);
+  }
+  else if(m_threads > 1)
+    solveParallel(run_seed);
+  else {
+    PathSearchState st;
+    initState(st, run_seed);
+    if(m_focus_poly < 0)
+      solveAux(st, 0, 0);
+    else {
+      solveAuxSide(st, 0, 0, 0);
+      solveAuxSide(st, 0, 0, 1);
+    }
+    mergeState(st);
+  }
+
+  if(m_focus_poly >= 0) {
+    if((m_dist_shortest_star >= 0) && ((m_dist_shortest_port < 0) ||
+				       (m_dist_shortest_star < m_dist_shortest_port))) {
+      m_dist_shortest = m_dist_shortest_star;
+      m_segl_shortest = m_segl_shortest_star;
+    }
+    else {
+      m_dist_shortest = m_dist_shortest_port;
+      m_segl_shortest = m_segl_shortest_port;
+    }
+  }
+  smoothShortest();
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: solveParallel()
+//   Purpose: Draw the top-level legs up front, then hand them out
+//            one at a time to the workers. With a focus poly each
+//            side gets its own set of top-level legs.
+
+void PathField::solveParallel(uint64_t run_seed)
+{
+  PathSearchState st;
+  initState(st, run_seed);
+
+  unsigned int sides = (m_focus_poly < 0) ? 1 : 2;
+  vector<double> legs_x, legs_y;
+  for(unsigned int i=0; i<(sides * m_branches); i++) {
+    double rx,ry;
+    genleg(st, m_sx,m_sy, m_dx,m_dy, 40, 40, rx,ry);
+    legs_x.push_back(rx);
+    legs_y.push_back(ry);
+  }
+
+  atomic<unsigned int> next_leg(0);
+  vector<PathSearchState> states(m_threads);
+  vector<thread> workers;
+  for(unsigned int i=0; i<m_threads; i++) {
+    initState(states[i], run_seed);
+    workers.push_back(thread(&PathField::solveWorker, this,
+			     ref(states[i]), ref(next_leg),
+			     cref(legs_x), cref(legs_y), run_seed));
+  }
+
+  for(unsigned int i=0; i<workers.size(); i++)
+    workers[i].join();
+  for(unsigned int i=0; i<states.size(); i++)
+    mergeState(states[i]);
+}
+
+//---------------------------------------------------------------
+// Procedure: solveWorker()
+//      Note: The generator is reseeded from the leg index, so each
+//            top-level subtree draws the same legs no matter which
+//            worker explores it.
+
+void PathField::solveWorker(PathSearchState& st,
+			    atomic<unsigned int>& next_leg,
+			    const vector<double>& legs_x,
+			    const vector<double>& legs_y,
+			    uint64_t run_seed)
+{
+  while(!timeUp(st)) {
+    unsigned int k = next_leg++;
+    if(k >= legs_x.size())
+      return;
+    st.rng.setSeed(run_seed ^ ((k+1) * 0x9e3779b97f4a7c15ULL));
+    if(m_focus_poly < 0)
+      extendPath(st, 0, 0, legs_x[k], legs_y[k]);
+    else
+      extendPathSide(st, 0, 0, k / m_branches, legs_x[k], legs_y[k]);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: initState()
+//   Purpose: Prepare a search state rooted at the source. Best
+//            paths start from those already held, so a repeated
+//            solve carries on improving the last result.
+
+void PathField::initState(PathSearchState& st, uint64_t seed) const
+{
+  st.nodes.clear();
+  st.path_segl.clear();
+  st.dead_sink = m_dead_sink;
+  st.dead_sink.clear();
+  st.dead_sink.setSeed(~seed);
+  st.rng.setSeed(seed);
+  st.coll_tests = 0;
+  st.ticks = 0;
+  st.tree = false;
+  st.open.clear();
+
+  st.segl_shortest = m_segl_shortest;
+  st.dist_shortest = m_dist_shortest;
+  st.segl_shortest_port = m_segl_shortest_port;
+  st.dist_shortest_port = m_dist_shortest_port;
+  st.segl_shortest_star = m_segl_shortest_star;
+  st.dist_shortest_star = m_dist_shortest_star;
+
+  addNode(st, -1, m_sx, m_sy, 0);
+}
+
+//---------------------------------------------------------------
+// Procedure: mergeState()
+
+void PathField::mergeState(PathSearchState& st)
+{
+  m_coll_tests += st.coll_tests;
+  m_dead_sink.merge(st.dead_sink);
+
+  if((st.dist_shortest >= 0) &&
+     ((m_dist_shortest < 0) || (st.dist_shortest < m_dist_shortest))) {
+    m_segl_shortest = st.segl_shortest;
+    m_dist_shortest = st.dist_shortest;
+  }
+  if((st.dist_shortest_port >= 0) && ((m_dist_shortest_port < 0) ||
+				      (st.dist_shortest_port < m_dist_shortest_port))) {
+    m_segl_shortest_port = st.segl_shortest_port;
+    m_dist_shortest_port = st.dist_shortest_port;
+  }
+  if((st.dist_shortest_star >= 0) && ((m_dist_shortest_star < 0) ||
+				      (st.dist_shortest_star < m_dist_shortest_star))) {
+    m_segl_shortest_star = st.segl_shortest_star;
+    m_dist_shortest_star = st.dist_shortest_star;
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: lowerBound()
+//   Purpose: Atomically lower the shared bound to the given value,
+//            treating a negative bound as no bound yet.
+
+void PathField::lowerBound(atomic<double>& bound, double val)
+{
+  double cur = bound.load();
+  while(((cur < 0) || (val < cur)) && !bound.compare_exchange_weak(cur, val));
+}
+
+//---------------------------------------------------------------
+// Procedure: timeUp()
+//   Purpose: Check whether the search should wind up, either on a
+//            stop() request or because the budget is spent. The
+//            clock is read only on every 64th call, as the calls
+//            come many times per millisecond.
+
+bool PathField::timeUp(PathSearchState& st)
+{
+  if(m_stop.load(memory_order_relaxed))
+    return(true);
+  if(!m_deadline_on)
+    return(false);
+
+  st.ticks++;
+  if((st.ticks % 64) != 0)
+    return(false);
+  if(chrono::steady_clock::now() < m_deadline)
+    return(false);
+
+  m_stop = true;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: publish()
+//   Purpose: Make a path found during the solve available to other
+//            threads, if shorter than any published so far, and
+//            pass it to the progress callback. The callback is run
+//            on the search thread that found the path.
+
+void PathField::publish(const XYSegList& segl, double dist)
+{
+  if(dist < 0)
+    return;
+
+  lock_guard<mutex> lock(m_progress_mutex);
+  if((m_progress_dist >= 0) && (dist >= m_progress_dist))
+    return;
+
+  m_progress_segl = segl;
+  m_progress_dist = dist;
+  m_progress_count++;
+  if(m_progress_cb)
+    m_progress_cb(m_progress_segl, m_progress_dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: resetProgress()
+//   Purpose: Drop the published path, e.g., when the source or dest
+//            has changed, so that a path to the new ends is not
+//            held back by a shorter one to the old ends.
+
+void PathField::resetProgress()
+{
+  lock_guard<mutex> lock(m_progress_mutex);
+  m_progress_segl.clear();
+  m_progress_dist = -1;
+}
+
+//---------------------------------------------------------------
+// Procedure: getProgress()
+//   Purpose: Get the best path published so far. Safe to call from
+//            any thread while a solve is running.
+//   Returns: false if no path has been found.
+
+bool PathField::getProgress(XYSegList& segl, double& dist) const
+{
+  lock_guard<mutex> lock(m_progress_mutex);
+  if(m_progress_dist < 0)
+    return(false);
+  segl = m_progress_segl;
+  dist = m_progress_dist;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: setSolveMode()
+//   Purpose: Choose between the random search (random), the
+//            visibility graph A* search (vgraph) and the anytime
+//            informed RRT* search (rrt).
+
+bool PathField::setSolveMode(string mode)
+{
+  mode = tolower(stripBlankEnds(mode));
+  if((mode != "random") && (mode != "vgraph") && (mode != "rrt"))
+    return(false);
+
+  m_solve_mode = mode;
+  clearSolve();
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: setSeed()
+//   Purpose: Seed the random search. Runs are numbered from zero
+//            after each seeding. With one thread, a given seed and
+//            run number replay the same search, given the same
+//            field and starting solution.
+//      Note: With more threads, each top-level subtree still draws
+//            its legs from the seed, but the workers share the best
+//            length bound, take subtrees and merge in whatever order
+//            the scheduler gives, so the pruning and the result may
+//            differ between runs of the same seed.
+
+void PathField::setSeed(unsigned int seed)
+{
+  m_seed = seed;
+  m_run_count = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: setDeadMode()
+//   Purpose: Choose how dead paths are kept: counts, sample or
+//            edges. See DeadPathSink.
+
+bool PathField::setDeadMode(string mode)
+{
+  if(!m_dead_sink.setMode(mode))
+    return(false);
+  m_revision++;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: setThreads()
+//   Purpose: Set the number of worker threads for the random
+//            search. Zero means one per hardware thread.
+
+void PathField::setThreads(unsigned int threads)
+{
+  if(threads == 0)
+    threads = thread::hardware_concurrency();
+  if(threads == 0)
+    threads = 1;
+  m_threads = threads;
+}
+
+//---------------------------------------------------------------
+// Procedure: setTurnRadius()
+//      Note: The held shortest path is smoothed again right away,
+//            so a new radius needs no new solve.
+
+void PathField::setTurnRadius(double radius)
+{
+  if(radius < 0)
+    radius = 0;
+  m_smoother.setTurnRadius(radius);
+  smoothShortest();
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: smoothShortest()
+//   Purpose: Turn the shortest path into one flyable with the turn
+//            radius, leaving the source on the source heading.
+
+void PathField::smoothShortest()
+{
+  m_segl_smooth.clear();
+  if((m_smoother.getTurnRadius() <= 0) || (m_segl_shortest.size() < 2))
+    return;
+
+  m_smoother.smooth(m_segl_shortest, m_sh, m_pieces, m_obs_grid,
+		    m_segl_smooth);
+}
+
+//---------------------------------------------------------------
+// Procedure: solveRRT()
+//   Purpose: Run the informed RRT* planner for the time budget.
+//            Each shorter path it finds is published as it comes,
+//            and the best is kept as the shortest path if it beats
+//            the one held, so the shortest path only ever improves
+//            over repeated solves.
+//      Note: The focus poly is not used in this mode.
+
+void PathField::solveRRT(uint64_t run_seed, double budget_ms)
+{
+  InformedRRT rrt(m_pieces, m_obs_grid);
+  rrt.setSeed(run_seed);
+  rrt.setStopFlag(&m_stop);
+  rrt.setCallback([this](const XYSegList& segl, double len) {
+      publish(segl, len);
+    });
+
+  double len = rrt.plan(m_sx, m_sy, m_dx, m_dy, budget_ms);
+  if((len >= 0) && ((m_dist_shortest < 0) || (len < m_dist_shortest))) {
+    m_segl_shortest = rrt.getPath();
+    m_dist_shortest = len;
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: solveVGraph()
+//   Purpose: Exact shortest path around the convex obstacles, by
+//            A* over the visibility graph of obstacle vertices.
+//            With a focus poly, the best path on each side is
+//            found, and the shorter kept as the overall best.
+//      Note: The graph over the obstacles is built only when the
+//            polys have changed. A query then costs only joining
+//            the source and dest to it, plus the search.
+
+void PathField::solveVGraph()
+{
+  clearSolve();
+
+  if(!m_vgraph_ok) {
+    m_vgraph.build(m_pieces, m_obs_grid);
+    m_vgraph_ok = true;
+  }
+  VisGraph& vgraph = m_vgraph;
+
+  if(m_focus_poly < 0) {
+    XYSegList path;
+    double dist = vgraph.shortestPath(m_sx, m_sy, m_dx, m_dy, path);
+    if(dist >= 0) {
+      m_segl_shortest = path;
+      m_dist_shortest = dist;
+    }
+    return;
+  }
+
+  XYSegList port_path, star_path;
+  double port_dist = solveVGraphSide(vgraph, 0, port_path);
+  double star_dist = solveVGraphSide(vgraph, 1, star_path);
+  if(port_dist >= 0) {
+    m_segl_shortest_port = port_path;
+    m_dist_shortest_port = port_dist;
+  }
+  if(star_dist >= 0) {
+    m_segl_shortest_star = star_path;
+    m_dist_shortest_star = star_dist;
+  }
+
+  if((star_dist >= 0) && ((port_dist < 0) || (star_dist < port_dist))) {
+    m_segl_shortest = star_path;
+    m_dist_shortest = star_dist;
+  }
+  else if(port_dist >= 0) {
+    m_segl_shortest = port_path;
+    m_dist_shortest = port_dist;
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: solveMany()
+//   Purpose: Shortest paths from the source to each of the given
+//            destinations. One shortest path tree is grown from the
+//            source over the visibility graph, and each destination
+//            is then joined to it. Destinations are shared out over
+//            the solver threads.
+//      Note: The focus poly and side preferences are not applied,
+//            and the held shortest paths are left unchanged.
+//   Returns: The number of destinations reached. For each, paths,
+//            dists (-1 if unreached) and the time (ms) to join it
+//            to the tree are returned in the given vectors.
+
+unsigned int PathField::solveMany(const vector<double>& dest_x,
+				  const vector<double>& dest_y,
+				  vector<XYSegList>& paths,
+				  vector<double>& dists,
+				  vector<double>& times_ms)
+{
+  unsigned int dsize = dest_x.size();
+  if(dest_y.size() < dsize)
+    dsize = dest_y.size();
+
+  paths.assign(dsize, XYSegList());
+  dists.assign(dsize, -1);
+  times_ms.assign(dsize, 0);
+  if(dsize == 0)
+    return(0);
+
+  if(!m_vgraph_ok) {
+    m_vgraph.build(m_pieces, m_obs_grid);
+    m_vgraph_ok = true;
+  }
+
+  auto tree_start = chrono::steady_clock::now();
+  vector<double> gcost;
+  vector<unsigned int> parent;
+  m_vgraph.shortestTree(m_sx, m_sy, gcost, parent);
+  chrono::duration<double, milli> tree_time;
+  tree_time = chrono::steady_clock::now() - tree_start;
+  m_many_tree_ms = tree_time.count();
+
+  unsigned int threads = m_threads;
+  if(threads > dsize)
+    threads = dsize;
+
+  atomic<unsigned int> next_dest(0);
+  if(threads <= 1)
+    solveManyWorker(next_dest, gcost, parent, dest_x, dest_y,
+		    paths, dists, times_ms);
+  else {
+    vector<thread> workers;
+    for(unsigned int i=0; i<threads; i++)
+      workers.push_back(thread(&PathField::solveManyWorker, this,
+			       ref(next_dest), cref(gcost), cref(parent),
+			       cref(dest_x), cref(dest_y), ref(paths),
+			       ref(dists), ref(times_ms)));
+    for(unsigned int i=0; i<workers.size(); i++)
+      workers[i].join();
+  }
+
+  unsigned int reached = 0;
+  for(unsigned int i=0; i<dsize; i++) {
+    if(dists[i] >= 0)
+      reached++;
+  }
+  return(reached);
+}
+
+//---------------------------------------------------------------
+// Procedure: solveManyWorker()
+//      Note: Each destination is written only by the worker that
+//            claimed it, so the result vectors need no lock.
+
+void PathField::solveManyWorker(atomic<unsigned int>& next_dest,
+				const vector<double>& gcost,
+				const vector<unsigned int>& parent,
+				const vector<double>& dest_x,
+				const vector<double>& dest_y,
+				vector<XYSegList>& paths,
+				vector<double>& dists,
+				vector<double>& times_ms) const
+{
+  while(true) {
+    unsigned int k = next_dest++;
+    if(k >= paths.size())
+      return;
+    auto start = chrono::steady_clock::now();
+    dists[k] = m_vgraph.pathFromTree(m_sx, m_sy, dest_x[k], dest_y[k],
+				     gcost, parent, paths[k]);
+    chrono::duration<double, milli> elapsed;
+    elapsed = chrono::steady_clock::now() - start;
+    times_ms[k] = elapsed.count();
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: solveVGraphSide()
+//   Purpose: Shortest path passing the focus poly on the given
+//            side (side=0 port, side=1 star), as judged by
+//            seglPassPoly(). The ray on the opposite side, from
+//            where it leaves the poly, is added as a barrier.
+//   Returns: Path length, or -1 if no path passes on that side.
+
+double PathField::solveVGraphSide(VisGraph& vgraph, int side,
+				  XYSegList& path)
+{
+  double port_x, port_y, port_hdg, star_x, star_y, star_hdg;
+  anchorRays(m_focus_poly, m_sx, m_sy,
+	     port_x, port_y, port_hdg, star_x, star_y, star_hdg);
+
+  double pcx = star_x;
+  double pcy = star_y;
+  double bar_ang = star_hdg;
+  if(side == 1) {
+    pcx = port_x;
+    pcy = port_y;
+    bar_ang = port_hdg;
+  }
+
+  // Barrier long enough to reach past all of the geometry
+  double bar_len = hypot(m_sx-pcx, m_sy-pcy) + hypot(m_dx-pcx, m_dy-pcy);
+  for(unsigned int i=0; i<m_polys.size(); i++) {
+    for(unsigned int j=0; j<m_polys[i].size(); j++) {
+      double dist = hypot(m_polys[i].get_vx(j)-pcx, m_polys[i].get_vy(j)-pcy);
+      bar_len = max(bar_len, dist);
+    }
+  }
+  bar_len = (2 * bar_len) + 100;
+
+  double bx, by;
+  projectPoint(bar_ang, bar_len, pcx, pcy, bx, by);
+
+  vgraph.addBarrier(pcx, pcy, bx, by);
+  double dist = vgraph.shortestPath(m_sx, m_sy, m_dx, m_dy, path);
+  vgraph.clearBarriers();
+  if(dist < 0)
+    return(-1);
+
+  string pside = seglPassPoly(m_focus_poly, path);
+  if((side == 0) && (pside != "port"))
+    return(-1);
+  if((side == 1) && (pside != "star"))
+    return(-1);
+
+  return(dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: setSearchOrder()
+//   Purpose: Choose the order the random search expands partial
+//            paths: depth-first in sample order (depth), cheapest
+//            lower bound first (best), or level by level keeping
+//            only the beam width cheapest at each level (beam).
+//            Ordering by cost finds a tight bound early, so more
+//            of the tree is pruned.
+//      Note: The best and beam orders run on a single thread.
+
+bool PathField::setSearchOrder(string order)
+{
+  order = tolower(stripBlankEnds(order));
+  if((order != "depth") && (order != "best") && (order != "beam"))
+    return(false);
+  m_search_order = order;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: solveTree()
+//   Purpose: Run the best-first or beam search, keeping the tree
+//            of partial paths in the arena. side=-1 means no
+//            focus poly, otherwise side=0 port, side=1 star.
+
+void PathField::solveTree(PathSearchState& st, int side)
+{
+  st.tree = true;
+  st.nodes.resize(1);
+  st.open.clear();
+
+  if(m_search_order == "beam")
+    solveBeam(st, side);
+  else
+    solveBestFirst(st, side);
+
+  st.tree = false;
+  st.nodes.resize(1);
+  st.open.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: solveBestFirst()
+//      Note: The open list is a min-heap on the lower bound of the
+//            full path through each node, its length so far plus
+//            the straight line on to the dest. Once the cheapest
+//            open node cannot beat the best path, none can.
+
+void PathField::solveBestFirst(PathSearchState& st, int side)
+{
+  greater<pair<double, unsigned int> > cmp;
+
+  expandNode(st, 0, side);
+  make_heap(st.open.begin(), st.open.end(), cmp);
+
+  while((st.open.size() > 0) && (st.nodes.size() < m_node_budget)) {
+    if(timeUp(st))
+      return;
+
+    pop_heap(st.open.begin(), st.open.end(), cmp);
+    double       f  = st.open.back().first;
+    unsigned int ix = st.open.back().second;
+    st.open.pop_back();
+
+    double bound = m_bound_shortest.load();
+    if(side == 0)
+      bound = m_bound_port.load();
+    else if(side == 1)
+      bound = m_bound_star.load();
+    if((bound >= 0) && (f >= bound))
+      return;
+
+    // Children are appended to the open list, then sifted in
+    unsigned int mark = st.open.size();
+    expandNode(st, ix, side);
+    for(unsigned int i=mark+1; i<=st.open.size(); i++)
+      push_heap(st.open.begin(), st.open.begin()+i, cmp);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: solveBeam()
+//   Purpose: Expand the tree a level at a time, to the same depth
+//            as the depth-first search, carrying on only the beam
+//            width cheapest children of each level.
+
+void PathField::solveBeam(PathSearchState& st, int side)
+{
+  vector<unsigned int> level(1, 0);
+  for(int depth=0; (depth<=5) && (level.size() > 0); depth++) {
+    st.open.clear();
+    for(unsigned int i=0; i<level.size(); i++) {
+      if(timeUp(st) || (st.nodes.size() >= m_node_budget))
+	return;
+      expandNode(st, level[i], side);
+    }
+
+    double bound = m_bound_shortest.load();
+    if(side == 0)
+      bound = m_bound_port.load();
+    else if(side == 1)
+      bound = m_bound_star.load();
+
+    unsigned int keep = min((unsigned int)(st.open.size()), m_beam_width);
+    partial_sort(st.open.begin(), st.open.begin()+keep, st.open.end());
+
+    level.clear();
+    for(unsigned int i=0; i<keep; i++) {
+      if((bound >= 0) && (st.open[i].first >= bound))
+	break;
+      level.push_back(st.open[i].second);
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: expandNode()
+//   Purpose: Try m_branches random legs from node ix. Legs to new
+//            partial paths add nodes to the open list.
+
+void PathField::expandNode(PathSearchState& st, unsigned int ix, int side)
+{
+  for(unsigned int i=0; i<m_branches; i++) {
+    double rx,ry;
+    genleg(st, m_sx,m_sy, m_dx,m_dy, 40, 40, rx,ry);
+    if(side < 0)
+      extendPath(st, ix, 0, rx,ry);
+    else
+      extendPathSide(st, ix, 0, side, rx,ry);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: solveAux()
+//      Note: The path so far is the chain of nodes from node ix
+//            back to the root. It is known to be collision-free,
+//            so only the new leg and the closing leg to the dest
+//            are checked. Child nodes are pushed onto the arena
+//            and popped once their subtree has been explored.
+
+void PathField::solveAux(PathSearchState& st, unsigned int ix, int depth)
+{
+  if(depth > 5)
+    return;
+
+  for(unsigned int i=0; i<m_branches; i++) {
+    if(timeUp(st))
+      return;
+    double rx,ry;
+    genleg(st, m_sx,m_sy, m_dx,m_dy, 40, 40, rx,ry);    
+    extendPath(st, ix, depth, rx,ry);
+  }
 }
 
 //---------------------------------------------------------------
-// Procedure: focusPoly()
+// Procedure: extendPath()
+//   Purpose: Try extending the path at node ix with a leg to rx,ry.
 
-void PathField::focusPoly(int ix)
+void PathField::extendPath(PathSearchState& st, unsigned int ix,
+			   int depth, double rx, double ry)
 {
-  if(ix < 0) {
-    m_focus_poly = -1;
+  double px = st.nodes[ix].x;
+  double py = st.nodes[ix].y;
+
+  if(!freeSeg(st, px,py, rx,ry)) {
+    addDead(st, ix, rx,ry, false);
     return;
   }
-    
-  if((unsigned int)(ix) >= m_polys.size())
+
+  // With side preferences, drop the path once it has passed any
+  // of their polys on the wrong side
+  uint64_t xport = st.nodes[ix].xport_bits;
+  uint64_t xstar = st.nodes[ix].xstar_bits;
+  if(m_pref_ok) {
+    legSignature(px,py, rx,ry, xport, xstar);
+    if(sideWrong(xport, xstar)) {
+      addDead(st, ix, rx,ry, true);
+      return;
+    }
+  }
+
+  double len = st.nodes[ix].len + hypot(rx-px, ry-py);
+  double full_dist = len + hypot(rx-m_dx, ry-m_dy);
+  double bound = m_bound_shortest.load();
+  if((bound >= 0) && (full_dist >= bound))
     return;
 
-  m_focus_poly = ix;
-  clearSolve();
-}
+  // A free leg on to the dest ends the path only if the path then
+  // meets all side preferences
+  bool reach = freeSeg(st, rx,ry, m_dx,m_dy);
+  if(reach && m_pref_ok) {
+    uint64_t fport = xport;
+    uint64_t fstar = xstar;
+    legSignature(rx,ry, m_dx,m_dy, fport, fstar);
+    reach = sideMet(fport, fstar);
+  }
 
+  if(reach) {
+    st.segl_shortest = seglFromNode(st, ix, rx,ry);
+    st.segl_shortest.add_vertex(m_dx,m_dy);
+    st.dist_shortest = full_dist;
+    lowerBound(m_bound_shortest, full_dist);
+    hedgeBestSegl(st);
+    publish(st.segl_shortest, st.dist_shortest);
+  }
+  else {
+    unsigned int mark = st.nodes.size();
+    addNode(st, ix, rx,ry, len);
+    st.nodes[mark].xport_bits = xport;
+    st.nodes[mark].xstar_bits = xstar;
+    if(st.tree)
+      st.open.push_back(make_pair(full_dist, mark));
+    else {
+      solveAux(st, mark, depth+1);
+      popNodes(st, mark);
+    }
+  }
+}
 
 //---------------------------------------------------------------
-// Procedure: focusPolyOff()
+// Procedure: solveAuxSide()
+//      Note: side=0 port, side=1 star
 
-void PathField::focusPolyOff()
+void PathField::solveAuxSide(PathSearchState& st, unsigned int ix,
+			     int depth, int side)
 {
-  m_focus_poly = -1;
-  clearSolve();
+  if(m_focus_poly < 0)
+    return;
+  
+  if(depth > 5)
+    return;
+  
+  for(unsigned int i=0; i<m_branches; i++) {
+    if(timeUp(st))
+      return;
+    double rx,ry;
+    genleg(st, m_sx,m_sy, m_dx,m_dy, 40, 40, rx,ry);    
+    extendPathSide(st, ix, depth, side, rx,ry);
+  }
 }
 
-
 //---------------------------------------------------------------
-// Procedure: focusPoly()
-
-void PathField::focusPoly(double vx, double vy)
+// Procedure: extendPathSide()
+//   Purpose: Try extending the path at node ix with a leg to rx,ry,
+//            keeping only paths passing the focus poly on the
+//            given side.
+//      Note: The side of passage is tracked per node by counting
+//            crossings of the focus poly rays leg by leg.
+
+void PathField::extendPathSide(PathSearchState& st, unsigned int ix,
+			       int depth, int side, double rx, double ry)
 {
-  int focus_poly = -1;
+  double px = st.nodes[ix].x;
+  double py = st.nodes[ix].y;
 
-  double closest_dist = -1;
+  // If this new leg hits an obstacle, we're done with this segl
+  if(!freeSeg(st, px,py, rx,ry)) {
+    addDead(st, ix, rx,ry, false);
+    return;
+  }
 
-  for(unsigned int i=0; i<m_polys.size(); i++) {
-    if(m_polys[i].contains(vx,vy)) {
-      double dist = m_polys[i].dist_to_poly(vx,vy);
-      if((closest_dist < 0) || (dist < closest_dist)) {
-	focus_poly = i;
-	closest_dist = dist;
-      }
+  // If the partial segl already passes the focus poly on the wrong
+  // side, we're done with this segl.
+  unsigned int xport = st.nodes[ix].xport;
+  unsigned int xstar = st.nodes[ix].xstar;
+  xport += crossRaySeg(m_focus_port_x,m_focus_port_y,m_focus_port, px,py,rx,ry);
+  xstar += crossRaySeg(m_focus_star_x,m_focus_star_y,m_focus_star, px,py,rx,ry);
+
+  string pside = focusPassSide(xport, xstar);
+  if((side == 0) && (pside == "star")) {
+    addDead(st, ix, rx,ry, true);
+    return;
+  }	
+  if((side == 1) && (pside == "port")) {
+    addDead(st, ix, rx,ry, true);
+    return;
+  }	
+
+  // Likewise for the side-preference polys
+  uint64_t xport_bits = st.nodes[ix].xport_bits;
+  uint64_t xstar_bits = st.nodes[ix].xstar_bits;
+  if(m_pref_ok) {
+    legSignature(px,py, rx,ry, xport_bits, xstar_bits);
+    if(sideWrong(xport_bits, xstar_bits)) {
+      addDead(st, ix, rx,ry, true);
+      return;
     }
   }
 
-  // If prior focus poly is selected, treat this as disabel request
-  if(focus_poly == m_focus_poly)
-    m_focus_poly = -1;
-  else if(focus_poly >= 0)
-    m_focus_poly = focus_poly;
+  // If partial segl extended hypothetically from the end of the
+  // segl directly to the dest (not checking yet for hitting other
+  // obstacles), does not have a improved shortest distance, we're
+  // done with this segl.
+  double len = st.nodes[ix].len + hypot(rx-px, ry-py);
+  double full_dist = len + hypot(rx-m_dx, ry-m_dy);
+  double bound = (side == 0) ? m_bound_port.load() : m_bound_star.load();
+  if((bound >= 0) && (full_dist >= bound))
+    return;
+
+  // If the partial segl can be extended collision-free to the dest,
+  // check if it is an improvement and satisfies the side.
+  if(freeSeg(st, rx,ry, m_dx,m_dy)) {
+    unsigned int fport = xport;
+    unsigned int fstar = xstar;
+    fport += crossRaySeg(m_focus_port_x,m_focus_port_y,m_focus_port, rx,ry,m_dx,m_dy);
+    fstar += crossRaySeg(m_focus_star_x,m_focus_star_y,m_focus_star, rx,ry,m_dx,m_dy);
+    string pside = focusPassSide(fport, fstar);
+    if(m_pref_ok) {
+      uint64_t fport_bits = xport_bits;
+      uint64_t fstar_bits = xstar_bits;
+      legSignature(rx,ry, m_dx,m_dy, fport_bits, fstar_bits);
+      if(!sideMet(fport_bits, fstar_bits))
+	pside = "";
+    }
+      
+    if((side == 0) && (pside == "port")) {
+      st.segl_shortest_port = seglFromNode(st, ix, rx,ry);
+      st.segl_shortest_port.add_vertex(m_dx,m_dy);
+      st.dist_shortest_port = full_dist;
+      lowerBound(m_bound_port, full_dist);
+      hedgeBestSeglPort(st);
+      publish(st.segl_shortest_port, st.dist_shortest_port);
+    }
+    else if((side == 1) && (pside == "star")) {
+      st.segl_shortest_star = seglFromNode(st, ix, rx,ry);
+      st.segl_shortest_star.add_vertex(m_dx,m_dy);
+      st.dist_shortest_star = full_dist;
+      lowerBound(m_bound_star, full_dist);
+      hedgeBestSeglStar(st);
+      publish(st.segl_shortest_star, st.dist_shortest_star);
+    }
+  }
+  else {
+    unsigned int mark = st.nodes.size();
+    addNode(st, ix, rx,ry, len);
+    st.nodes[mark].xport = xport;
+    st.nodes[mark].xstar = xstar;
+    st.nodes[mark].xport_bits = xport_bits;
+    st.nodes[mark].xstar_bits = xstar_bits;
+    if(st.tree)
+      st.open.push_back(make_pair(full_dist, mark));
+    else {
+      solveAuxSide(st, mark, depth+1, side);
+      popNodes(st, mark);
+    }
+  }
 }
 
 //---------------------------------------------------------------
-// Procedure: clearSolve()
+// Procedure: addDead()
+//   Purpose: Record the dead path made by extending node ix with a
+//            leg to rx,ry. The full path is built only if the
+//            dead path sink keeps it.
 
-void PathField::clearSolve()
+void PathField::addDead(PathSearchState& st, unsigned int ix,
+			double rx, double ry, bool wrong_side) const
 {
-  m_segls_dead.clear();
-  m_segl_shortest.clear();
-  m_dist_shortest = -1;
+  double px = st.nodes[ix].x;
+  double py = st.nodes[ix].y;
+  int slot = st.dead_sink.addDead(px,py, rx,ry, wrong_side);
+  if(slot >= 0)
+    st.dead_sink.setSample(slot, seglFromNode(st, ix, rx,ry));
+}
 
-  m_segl_shortest_port.clear();
-  m_dist_shortest_port = -1;
+//---------------------------------------------------------------
+// Procedure: addNode()
+//   Purpose: Push a new node onto the arena as a child of the
+//            given parent. Ray crossing counts start at the
+//            parent's counts.
 
-  m_segl_shortest_star.clear();
-  m_dist_shortest_star = -1;
+void PathField::addNode(PathSearchState& st, int parent,
+			double x, double y, double len) const
+{
+  PathNode node;
+  node.parent = parent;
+  node.x   = x;
+  node.y   = y;
+  node.len = len;
+  node.xport = 0;
+  node.xstar = 0;
+  node.xport_bits = 0;
+  node.xstar_bits = 0;
+  if(parent >= 0) {
+    node.xport = st.nodes[parent].xport;
+    node.xstar = st.nodes[parent].xstar;
+    node.xport_bits = st.nodes[parent].xport_bits;
+    node.xstar_bits = st.nodes[parent].xstar_bits;
+  }
+  st.nodes.push_back(node);
+  if(!st.tree)
+    st.path_segl.add_vertex(x,y);
 }
 
 //---------------------------------------------------------------
-// Procedure: solve()
+// Procedure: popNodes()
+//   Purpose: Pop nodes off the arena down to the given size.
 
-void PathField::solve()
+void PathField::popNodes(PathSearchState& st, unsigned int new_size) const
 {
-  m_segls_dead.clear();
+  while(st.nodes.size() > new_size) {
+    st.nodes.pop_back();
+    st.path_segl.delete_vertex(st.path_segl.size()-1);
+  }
+}
 
+//---------------------------------------------------------------
+// Procedure: seglFromNode()
+//   Purpose: Build the seglist for the path from the root to the
+//            given node, plus the extra vertex x,y at the end.
+//      Note: For the node on top of the arena the path is already
+//            held in the state's path_segl, and a copy is all
+//            that's needed.
+
+XYSegList PathField::seglFromNode(const PathSearchState& st,
+				  unsigned int ix, double x, double y) const
+{
   XYSegList segl;
-  segl.add_vertex(m_sx, m_sy);
+  if(!st.tree && ((ix+1) == st.nodes.size()))
+    segl = st.path_segl;
+  else
+    addChain(st, ix, segl);
+  segl.add_vertex(x,y);
+  return(segl);
+}
 
-  if(m_focus_poly < 0)
-    solveAux(segl, 0);
-  else {
-    solveAuxSide(segl, 0, 0);
-    solveAuxSide(segl, 0, 1);
-    
-    if(m_dist_shortest_star < m_dist_shortest_port) {
-      m_dist_shortest = m_dist_shortest_star;
-      m_segl_shortest = m_segl_shortest_star;
-    }
-    else {
-      m_dist_shortest = m_dist_shortest_port;
-      m_segl_shortest = m_segl_shortest_port;
-    }
-  }
+//---------------------------------------------------------------
+// Procedure: addChain()
+//   Purpose: Append the vertices from the root to the given node.
+
+void PathField::addChain(const PathSearchState& st, unsigned int ix,
+			 XYSegList& segl) const
+{
+  if(st.nodes[ix].parent >= 0)
+    addChain(st, st.nodes[ix].parent, segl);
+  segl.add_vertex(st.nodes[ix].x, st.nodes[ix].y);
 }
 
 //---------------------------------------------------------------
-// Procedure: solveAux()
+// Procedure: setFocusRays()
+//   Purpose: Set the port and starboard rays of the focus poly as
+//            used by seglPassPoly() for paths from the source.
 
-void PathField::solveAux(XYSegList segl, int depth)
+void PathField::setFocusRays()
 {
-  if(depth > 5)
+  m_focus_ok = false;
+  if((m_focus_poly < 0) || ((unsigned int)(m_focus_poly) >= m_polys.size()))
     return;
-  
-  XYPoint pt = segl.get_last_point();
-  double  sx = pt.x();
-  double  sy = pt.y();
 
-  for(unsigned int i=0; i<m_branches; i++) {
-    double rx,ry;
-    genleg(m_sx,m_sy, m_dx,m_dy, 40, 40, rx,ry);    
-    
-    XYSegList new_segl = segl;
-    new_segl.add_vertex(rx,ry);
-
-    if(!freeSegl(new_segl)) {
-      m_segls_dead.push_back(new_segl);
-      continue;
-    }
+  m_focus_ok = m_anchor_ok[m_focus_poly];
+  anchorRays(m_focus_poly, m_sx, m_sy,
+	     m_focus_port_x, m_focus_port_y, m_focus_port,
+	     m_focus_star_x, m_focus_star_y, m_focus_star);
+}
 
-    double full_dist = new_segl.length() + hypot(rx-m_dx, ry-m_dy);
-    if((m_dist_shortest >= 0) && (full_dist >= m_dist_shortest))
-      continue;
+//---------------------------------------------------------------
+// Procedure: setSidePref()
+//   Purpose: Ask that paths pass poly ix on the given side: port,
+//            star, or none to drop a preference. Any number of
+//            polys, up to 64 at once, may have a preference, and
+//            all are met in one solve of the random search.
+//      Note: Dropping a preference frees its slot for reuse.
+
+bool PathField::setSidePref(unsigned int ix, string side)
+{
+  side = tolower(stripBlankEnds(side));
+  if((ix >= m_polys.size()) ||
+     ((side != "port") && (side != "star") && (side != "none")))
+    return(false);
 
-    if(fullSegl(new_segl)) {
-      new_segl.add_vertex(m_dx,m_dy);      
-      m_segl_shortest = new_segl;
-      m_dist_shortest = full_dist;
-      hedgeBestSegl();
-    }
-    else {
-      solveAux(new_segl, depth+1);
-    }
+  // Find the slot for this poly, or a free one
+  uint64_t used = m_pref_port | m_pref_star;
+  unsigned int k = 0;
+  while((k < m_pref_polys.size()) &&
+	!(((used >> k) & 1) && (m_pref_polys[k] == ix)))
+    k++;
+  if(k == m_pref_polys.size()) {
+    if(side == "none")
+      return(true);
+    k = 0;
+    while((k < m_pref_polys.size()) && ((used >> k) & 1))
+      k++;
+    if(k >= 64)
+      return(false);
+    if(k == m_pref_polys.size())
+      m_pref_polys.push_back(ix);
+    else
+      m_pref_polys[k] = ix;
   }
+
+  uint64_t bit = (uint64_t)(1) << k;
+  m_pref_port &= ~bit;
+  m_pref_star &= ~bit;
+  if(side == "port")
+    m_pref_port |= bit;
+  else if(side == "star")
+    m_pref_star |= bit;
+
+  // Trim free slots off the end
+  used = m_pref_port | m_pref_star;
+  while((m_pref_polys.size() > 0) &&
+	!((used >> (m_pref_polys.size()-1)) & 1))
+    m_pref_polys.pop_back();
+
+  clearSolve();
+  return(true);
 }
 
 //---------------------------------------------------------------
-// Procedure: solveAuxSide()
-//      Note: side=0 port, side=1 star
+// Procedure: cycleSidePref()
+//   Purpose: Step the side preference of the poly containing x,y
+//            from none to port to star and back to none.
 
-void PathField::solveAuxSide(XYSegList segl, int depth, int side)
+void PathField::cycleSidePref(double x, double y)
 {
-  if(m_focus_poly < 0)
+  int ix = polyAt(x, y);
+  if(ix < 0)
     return;
-  
-  if(depth > 5)
-    return;
-  
-  XYPoint pt = segl.get_last_point();
-  double  sx = pt.x();
-  double  sy = pt.y();
 
-  for(unsigned int i=0; i<m_branches; i++) {
-    double rx,ry;
-    genleg(m_sx,m_sy, m_dx,m_dy, 40, 40, rx,ry);    
-    
-    XYSegList new_segl = segl;
-    new_segl.add_vertex(rx,ry);
+  string side = getSidePref(ix);
+  if(side == "port")
+    setSidePref(ix, "star");
+  else if(side == "star")
+    setSidePref(ix, "none");
+  else
+    setSidePref(ix, "port");
+}
+
+//---------------------------------------------------------------
+// Procedure: clearSidePrefs()
+
+void PathField::clearSidePrefs()
+{
+  m_pref_polys.clear();
+  m_pref_port = 0;
+  m_pref_star = 0;
+  m_pref_ok = 0;
+  m_need_port = 0;
+  m_need_star = 0;
+  m_revision++;
+}
+
+//---------------------------------------------------------------
+// Procedure: getSidePref()
 
-    // If this partial segl hits an obstacle, we're done with this segl
-    if(!freeSegl(new_segl)) {
-      m_segls_dead.push_back(new_segl);
+string PathField::getSidePref(unsigned int ix) const
+{
+  for(unsigned int k=0; k<m_pref_polys.size(); k++) {
+    if(m_pref_polys[k] != ix)
       continue;
-    }
+    uint64_t bit = (uint64_t)(1) << k;
+    if(m_pref_port & bit)
+      return("port");
+    if(m_pref_star & bit)
+      return("star");
+  }
+  return("none");
+}
 
-    // If the partial segl already passes the focus poly on the wrong
-    // side, we're done with this segl.
-    string pside = seglPassPoly(m_polys[m_focus_poly], new_segl);
-    if((side == 0) && (pside == "star")) {
-      m_segls_dead.push_back(new_segl);
+//---------------------------------------------------------------
+// Procedure: setSideRays()
+//   Purpose: Set the port and starboard rays of each side-preference
+//            poly, by the same rule as seglPassPoly(), for paths
+//            from the source, and the masks of the polys judged.
+
+void PathField::setSideRays()
+{
+  unsigned int prefs = m_pref_polys.size();
+  m_pref_ax.resize(prefs);
+  m_pref_ay.resize(prefs);
+  m_pref_ux.resize(prefs);
+  m_pref_uy.resize(prefs);
+  m_pref_port_u.resize(prefs);
+  m_pref_star_u.resize(prefs);
+  m_pref_ok = 0;
+
+  for(unsigned int k=0; k<prefs; k++) {
+    uint64_t bit = (uint64_t)(1) << k;
+    unsigned int ix = m_pref_polys[k];
+    if(!m_anchor_ok[ix] || !((m_pref_port | m_pref_star) & bit))
       continue;
-    }	
-    if((side == 1) && (pside == "port")) {
-      m_segls_dead.push_back(new_segl);
+
+    double port_x, port_y, port_hdg, star_x, star_y, star_hdg;
+    anchorRays(ix, m_sx, m_sy,
+	       port_x, port_y, port_hdg, star_x, star_y, star_hdg);
+
+    double ax = m_anchor_x[ix];
+    double ay = m_anchor_y[ix];
+    double ux, uy;
+    projectPoint(port_hdg, 1, 0, 0, ux, uy);
+    m_pref_ax[k] = ax;
+    m_pref_ay[k] = ay;
+    m_pref_ux[k] = ux;
+    m_pref_uy[k] = uy;
+    m_pref_port_u[k] = (port_x - ax) * ux + (port_y - ay) * uy;
+    m_pref_star_u[k] = (star_x - ax) * ux + (star_y - ay) * uy;
+    m_pref_ok |= bit;
+  }
+  m_need_port = m_pref_port & m_pref_ok;
+  m_need_star = m_pref_star & m_pref_ok;
+}
+
+//---------------------------------------------------------------
+// Procedure: legSignature()
+//   Purpose: Add the crossings of one leg to a path's crossing word,
+//            setting bit k of xport (xstar) if the leg crosses the
+//            port (star) ray of side-preference poly k.
+//      Note: Both rays of a poly lie on one line, so the leg meets
+//            it at most once. Only the judged polys are visited,
+//            each with one side-of-line test, and the position of
+//            the crossing along the line gives the ray.
+
+void PathField::legSignature(double x1, double y1, double x2, double y2,
+			     uint64_t& xport, uint64_t& xstar) const
+{
+  uint64_t todo = m_pref_ok;
+  while(todo) {
+    unsigned int k = __builtin_ctzll(todo);
+    todo &= (todo - 1);
+
+    double rx1 = x1 - m_pref_ax[k];
+    double ry1 = y1 - m_pref_ay[k];
+    double rx2 = x2 - m_pref_ax[k];
+    double ry2 = y2 - m_pref_ay[k];
+    double ux = m_pref_ux[k];
+    double uy = m_pref_uy[k];
+
+    // Side of the line at each end of the leg
+    double s1 = ux * ry1 - uy * rx1;
+    double s2 = ux * ry2 - uy * rx2;
+    if(((s1 > 0) && (s2 > 0)) || ((s1 < 0) && (s2 < 0)) || (s1 == s2))
       continue;
-    }	
-
-    // If partial segl extended hypothetically from the end of the
-    // segl directly to the dest (not checking yet for hitting other
-    // obstacles), does not have a improved shortest distance, we're
-    // done with this segl.
-    double full_dist = new_segl.length() + hypot(rx-m_dx, ry-m_dy);
-    if(side == 0) {
-      if((m_dist_shortest_port >= 0) && (full_dist >= m_dist_shortest_port))
-	continue;
-    }
-    else {
-      if((m_dist_shortest_star >= 0) && (full_dist >= m_dist_shortest_star))
-	continue;
-    }    
 
-    // If the partial segl can be extended collision-free to the dest,
-    // check if it is an improvement and satisfies the side.
-    if(fullSegl(new_segl)) {
-      new_segl.add_vertex(m_dx,m_dy);      
-      string pside = seglPassPoly(m_polys[m_focus_poly], new_segl);
-      
-      if((side == 0) && (pside == "port")) {
-	m_segl_shortest_port = new_segl;
-	m_dist_shortest_port = full_dist;
-	hedgeBestSeglPort();
-      }
-      else if(pside == "star") {
-	m_segl_shortest_star = new_segl;
-	m_dist_shortest_star = full_dist;
-	hedgeBestSeglStar();
-      }
-    }
-    else {
-      solveAuxSide(new_segl, depth+1, side);
-    }
+    double f = s1 / (s1 - s2);
+    double u = (rx1 + f * (rx2 - rx1)) * ux + (ry1 + f * (ry2 - ry1)) * uy;
+    uint64_t bit = (uint64_t)(1) << k;
+    if(u >= m_pref_port_u[k])
+      xport |= bit;
+    else if(u <= m_pref_star_u[k])
+      xstar |= bit;
   }
 }
 
+//---------------------------------------------------------------
+// Procedure: seglSignature()
+
+void PathField::seglSignature(const XYSegList& segl,
+			      uint64_t& xport, uint64_t& xstar) const
+{
+  xport = 0;
+  xstar = 0;
+  for(unsigned int i=0; (i+1)<segl.size(); i++)
+    legSignature(segl.get_vx(i), segl.get_vy(i),
+		 segl.get_vx(i+1), segl.get_vy(i+1), xport, xstar);
+}
+
+//---------------------------------------------------------------
+// Procedure: sideWrong()
+//   Purpose: Check a partial path's crossing word against all the
+//            side preferences at once, by the masks set in
+//            setSideRays(). As with focusPassSide(), a port
+//            crossing decides the side, else a star crossing.
+//   Returns: true if some poly has been passed on the wrong side.
+
+bool PathField::sideWrong(uint64_t xport, uint64_t xstar) const
+{
+  return(((m_need_port & xstar & ~xport) | (m_need_star & xport)) != 0);
+}
+
+//---------------------------------------------------------------
+// Procedure: sideMet()
+//   Returns: true if a full path's crossing word passes every poly
+//            with a side preference on that side.
+
+bool PathField::sideMet(uint64_t xport, uint64_t xstar) const
+{
+  return(((m_need_port & ~xport) | (m_need_star & ~(xstar & ~xport))) == 0);
+}
+
+//---------------------------------------------------------------
+// Procedure: focusPassSide()
+//   Purpose: Same rule as seglPassPoly(), given the ray crossing
+//            counts of a path from the source.
+
+string PathField::focusPassSide(unsigned int xport,
+				unsigned int xstar) const
+{
+  if(!m_focus_ok)
+    return("");
+  if(xport > 0)
+    return("port");
+  else if(xstar > 0)
+    return("star");
+  return("");
+}
+
 //---------------------------------------------------------------
 // Procedure: genleg()
 //   Purpose: Generate a random leg from the given start position
@@ -279,29 +2154,26 @@ void PathField::solveAuxSide(XYSegList segl, int depth, int side)
 //            Legal range for distrng = (0,50], meaning legs will be
 //            somewhere between 0 and 100% of the straightline dist
 //            between source and dest.
+//      Note: Draws from the given search state's generator, so
+//            each worker thread has its own. Draws are continuous
+//            rather than whole hundredths as with rand().
 
-void PathField::genleg(double sx, double sy,
+void PathField::genleg(PathSearchState& st,
+		       double sx, double sy,
 		       double dx, double dy,
 		       double angrng, double distrng,
-		       double& rx, double& ry)
+		       double& rx, double& ry) const
 {
   double ang_to_dest = relAng(sx, sy, dx, dy);
   double dist_to_dest = hypot(sx-dx, sy-dy);
 
-  int int_rand_hdg = rand() % ((int)(angrng * 2 * 100));
-  double rand_hdg  = ((double)(int_rand_hdg)) / 100.0;
-  
-  int int_rand_dist = rand() % ((int)(distrng * 2 * 100));
-  double rand_dist  = ((double)(int_rand_dist)) / 100.0;
-
-  // rand_hdg is in the range [0, 2*hdg]. Convert to [-hdg,+hdg].
-  rand_hdg -= angrng;
+  // rand_hdg is in the range [-angrng,+angrng]
+  double rand_hdg = st.rng.uniform(-angrng, angrng);
   
   double hdg = ang_to_dest + rand_hdg;
 
-  // rand_dist is in range [0,distrng], e.g., [0,60]
-  // Convert to [50-distrng,50+distrng], e.g., [20,80]
-  rand_dist = (50-distrng) + rand_dist;
+  // rand_dist is in range [50-distrng,50+distrng], e.g., [20,80]
+  double rand_dist = st.rng.uniform(50-distrng, 50+distrng);
 
   double dist = (rand_dist / 100) * dist_to_dest;
   
@@ -313,14 +2185,20 @@ void PathField::genleg(double sx, double sy,
 // Procedure: freeSeg()
 //   Purpose: Determine if the given line segment intersects with
 //            any of the polygon obstacles
+//      Note: Only obstacles near the segment, per the obstacle
+//            grid, are given the exact intersection test.
 
-bool PathField::freeSeg(double sx, double sy, double dx, double dy)
+bool PathField::freeSeg(PathSearchState& st, double sx, double sy,
+			double dx, double dy) const
 {
-  if(m_polys.size() == 0)
+  st.coll_tests++;
+  if(m_pieces.size() == 0)
     return(true);
 
-  for(unsigned int i=0; i<m_polys.size(); i++) {
-    if(m_polys[i].seg_intercepts(sx,sy, dx,dy))
+  vector<unsigned int>& cands = st.obs_cands;
+  m_obs_grid.segCandidates(sx,sy, dx,dy, cands);
+  for(unsigned int i=0; i<cands.size(); i++) {
+    if(m_pieces[cands[i]].seg_intercepts(sx,sy, dx,dy))
       return(false);
   }
 
@@ -332,9 +2210,9 @@ bool PathField::freeSeg(double sx, double sy, double dx, double dy)
 //   Purpose: Determine if the given seglist intersects with any
 //            of the polygon obstacles
 
-bool PathField::freeSegl(const XYSegList& seglr)
+bool PathField::freeSegl(PathSearchState& st, const XYSegList& seglr) const
 {
-  if(m_polys.size() == 0)
+  if(m_pieces.size() == 0)
     return(true);
 
   if(seglr.size() == 0)
@@ -343,8 +2221,10 @@ bool PathField::freeSegl(const XYSegList& seglr)
   if(seglr.size() == 1) {
     double vx = seglr.get_vx(0);
     double vy = seglr.get_vy(0);
-    for(unsigned int i=0; i<m_polys.size(); i++) {
-      if(m_polys[i].contains(vx,vy))
+    vector<unsigned int>& cands = st.obs_cands;
+    m_obs_grid.ptCandidates(vx, vy, cands);
+    for(unsigned int i=0; i<cands.size(); i++) {
+      if(m_pieces[cands[i]].contains(vx,vy))
 	return(true);
     }
   }
@@ -354,37 +2234,17 @@ bool PathField::freeSegl(const XYSegList& seglr)
     double vy1 = seglr.get_vy(i);
     double vx2 = seglr.get_vx(i+1);
     double vy2 = seglr.get_vy(i+1);
-    if(!freeSeg(vx1,vy1, vx2,vy2))
+    if(!freeSeg(st, vx1,vy1, vx2,vy2))
       return(false);
   }
 
   return(true);
 }
 
-//---------------------------------------------------------------
-// Procedure: fullSegl()
-//   Purpose: Determine if the given seglist, augmented with an
-//            additional leg from the last point to the dest, 
-//            represents a collision-free path from start to dest.
-
-
-bool PathField::fullSegl(XYSegList seglr)
-{
-  if(m_polys.size() == 0)
-    return(true);
-
-  if(seglr.size() == 0)
-    return(false);
-
-  seglr.add_vertex(m_dx,m_dy);
-
-  return(freeSegl(seglr));
-}
-
 //---------------------------------------------------------------
 // Procedure: getPolyPassSide()
 
-string PathField::getPolyPassSide(unsigned int ix)
+string PathField::getPolyPassSide(unsigned int ix) const
 {
   // Sanity checks
   if(ix >= m_polys.size())
@@ -394,7 +2254,7 @@ string PathField::getPolyPassSide(unsigned int ix)
   if(m_dist_shortest < 0)
     return("");
 
-  return(seglPassPoly(m_polys[ix], m_segl_shortest));
+  return(seglPassPoly(ix, m_segl_shortest));
 }
 
 //---------------------------------------------------------------
@@ -403,25 +2263,23 @@ string PathField::getPolyPassSide(unsigned int ix)
 //            and if so, on which side.
 //            To pass a poly, the segl (at least one segment) must
 //            cross the line perpendicular to the line between the
-//            source point (sx,sy) and the center of the polygon. 
+//            source point (sx,sy) and the anchor of the polygon,
+//            its center if convex, or the center of its largest
+//            cover piece if not. See anchorRays() for where the
+//            port and star rays of that line begin.
 
-string PathField::seglPassPoly(XYPolygon poly, XYSegList segl)
+string PathField::seglPassPoly(unsigned int ix,
+			       const XYSegList& segl) const
 {
-  if(!poly.is_convex() || (segl.size() < 2))
+  if((ix >= m_polys.size()) || !m_anchor_ok[ix] || (segl.size() < 2))
     return("");
 
-  double sx = segl.get_vx(0);
-  double sy = segl.get_vy(0);
-  
-  double pcx = poly.get_center_x();
-  double pcy = poly.get_center_y();
-  double ang_to_pcent = relAng(sx,sy, pcx,pcy);
+  double px, py, port_hdg, stx, sty, star_hdg;
+  anchorRays(ix, segl.get_vx(0), segl.get_vy(0),
+	     px, py, port_hdg, stx, sty, star_hdg);
 
-  double star_ang = angle360(ang_to_pcent + 90);
-  double port_ang = angle360(ang_to_pcent - 90);
-  
-  unsigned int xport = crossRaySegl(pcx,pcy,port_ang, segl);
-  unsigned int xstar = crossRaySegl(pcx,pcy,star_ang, segl);
+  unsigned int xport = crossRaySegl(px,py,port_hdg, segl);
+  unsigned int xstar = crossRaySegl(stx,sty,star_hdg, segl);
 
   if(xport > 0)
     return("port");
@@ -431,6 +2289,65 @@ string PathField::seglPassPoly(XYPolygon poly, XYSegList segl)
     return("");
 }
 
+//---------------------------------------------------------------
+// Procedure: anchorRays()
+//   Purpose: Set the port and star rays of poly ix for paths from
+//            sx,sy. Both lie on the line through the anchor that
+//            is perpendicular to the line from sx,sy, and each
+//            begins where it leaves the poly border for good.
+//      Note: On a non-convex poly the ray from the anchor may
+//            cross a bay of the poly before leaving it. A path
+//            dipping into that bay from the other side would then
+//            cross the ray without passing the poly on its side.
+//            The poly plus the clipped ray still cut the plane, so
+//            no path gets around the poly without crossing one.
+
+void PathField::anchorRays(unsigned int ix, double sx, double sy,
+			   double& port_x, double& port_y, double& port_hdg,
+			   double& star_x, double& star_y, double& star_hdg) const
+{
+  double ax = m_anchor_x[ix];
+  double ay = m_anchor_y[ix];
+  double ang_to_pcent = relAng(sx,sy, ax,ay);
+
+  port_hdg = angle360(ang_to_pcent - 90);
+  star_hdg = angle360(ang_to_pcent + 90);
+  rayExit(m_polys[ix], ax, ay, port_hdg, port_x, port_y);
+  rayExit(m_polys[ix], ax, ay, star_hdg, star_x, star_y);
+}
+
+//---------------------------------------------------------------
+// Procedure: rayExit()
+//   Purpose: Find the point where the ray from px,py at heading ph
+//            crosses the border of the poly for the last time. If
+//            it never crosses, the ray origin is given.
+
+void PathField::rayExit(const XYPolygon& poly, double px, double py,
+			double ph, double& ex, double& ey) const
+{
+  double ux, uy;
+  projectPoint(ph, 1, 0, 0, ux, uy);
+
+  double tmax = 0;
+  unsigned int vsize = poly.size();
+  for(unsigned int i=0; i<vsize; i++) {
+    double x1 = poly.get_vx(i);
+    double y1 = poly.get_vy(i);
+    double x2 = poly.get_vx((i+1) % vsize);
+    double y2 = poly.get_vy((i+1) % vsize);
+    double ex1 = x2 - x1;
+    double ey1 = y2 - y1;
+    double denom = ux * ey1 - uy * ex1;
+    if(denom == 0)
+      continue;
+    double t = ((x1-px) * ey1 - (y1-py) * ex1) / denom;
+    double s = ((x1-px) * uy - (y1-py) * ux) / denom;
+    if((t > tmax) && (s >= 0) && (s <= 1))
+      tmax = t;
+  }
+  ex = px + tmax * ux;
+  ey = py + tmax * uy;
+}
   
 //---------------------------------------------------------------
 // Procedure: crossRaySegl()
@@ -438,7 +2355,7 @@ string PathField::seglPassPoly(XYPolygon poly, XYSegList segl)
 //            SegList and count the number of crosses.
 
 unsigned int PathField::crossRaySegl(double px, double py, double ph,
-				     const XYSegList& segl)
+				     const XYSegList& segl) const
 {
   unsigned int vsize = segl.size();
   if(vsize < 2)
@@ -448,126 +2365,156 @@ unsigned int PathField::crossRaySegl(double px, double py, double ph,
   
   // For each line segment
   for(unsigned int i=0; i<vsize-1; i++) {
-
     double x1 = segl.get_vx(i);
     double y1 = segl.get_vy(i);
     double x2 = segl.get_vx(i+1);
     double y2 = segl.get_vy(i+1);
+    crosses += crossRaySeg(px, py, ph, x1, y1, x2, y2);
+  }
+  return(crosses);
+}  
 
-    double ix, iy;
-    bool may_intersect = lineRayCross(px, py, ph, x1, y1, x2, y2, ix, iy);
-
-    if(may_intersect) {
-      bool x_intersect = false;
-      if((x1==x2) && (x1==ix))
-	x_intersect = true;
-      else if((x1>x2) && (ix>=x2) && (ix<=x1))
-	x_intersect = true;
-      else {
-	if((ix>=x1) && (ix<=x2))
-	  x_intersect = true;
-      }
 
-      bool y_intersect = false;
-      if((y1==y2) && (y1==iy))
-	y_intersect = true;
-      else if((y1>y2) && (iy>=y2) && (iy<=y1))
-	y_intersect = true;
-      else {
-	if((iy>=y1) && (iy<=y2))
-	  y_intersect = true;
-      }
+//---------------------------------------------------------------
+// Procedure: crossRaySeg()
+//   Purpose: Determine if the given ray crosses the line segment.
+//   Returns: 1 if it crosses, 0 otherwise
 
-      if(x_intersect && y_intersect)
-	crosses++;
-    }
+unsigned int PathField::crossRaySeg(double px, double py, double ph,
+				    double x1, double y1,
+				    double x2, double y2) const
+{
+  double ix, iy;
+  bool may_intersect = lineRayCross(px, py, ph, x1, y1, x2, y2, ix, iy);
+  if(!may_intersect)
+    return(0);
+
+  bool x_intersect = false;
+  if((x1==x2) && (x1==ix))
+    x_intersect = true;
+  else if((x1>x2) && (ix>=x2) && (ix<=x1))
+    x_intersect = true;
+  else {
+    if((ix>=x1) && (ix<=x2))
+      x_intersect = true;
   }
-  return(crosses);
-}  
+
+  bool y_intersect = false;
+  if((y1==y2) && (y1==iy))
+    y_intersect = true;
+  else if((y1>y2) && (iy>=y2) && (iy<=y1))
+    y_intersect = true;
+  else {
+    if((iy>=y1) && (iy<=y2))
+      y_intersect = true;
+  }
+
+  if(x_intersect && y_intersect)
+    return(1);
+  return(0);
+}
 
 
 //---------------------------------------------------------------
 // Procedure: hedgeBestSegl()
 
-void PathField::hedgeBestSegl()
+void PathField::hedgeBestSegl(PathSearchState& st)
 {
-  XYSegList new_segl = simplifySegl(m_segl_shortest);
+  XYSegList new_segl = simplifySegl(st, st.segl_shortest);
   if(new_segl.size() == 0)
     return;
-  m_segl_shortest = new_segl;
-  m_dist_shortest = new_segl.length();
+  if(m_pref_ok) {
+    uint64_t xport, xstar;
+    seglSignature(new_segl, xport, xstar);
+    if(!sideMet(xport, xstar))
+      return;
+  }
+  st.segl_shortest = new_segl;
+  st.dist_shortest = new_segl.length();
+  lowerBound(m_bound_shortest, st.dist_shortest);
 }
 
 //---------------------------------------------------------------
 // Procedure: hedgeBestSeglStar()
 
-void PathField::hedgeBestSeglStar()
+void PathField::hedgeBestSeglStar(PathSearchState& st)
 {
-  XYSegList new_segl = simplifySegl(m_segl_shortest_star);
+  XYSegList new_segl = simplifySegl(st, st.segl_shortest_star);
   if(new_segl.size() == 0)
     return;
   
-  string pside = seglPassPoly(m_polys[m_focus_poly], new_segl);
+  string pside = seglPassPoly(m_focus_poly, new_segl);
   if(pside != "star")
     return;
+  if(m_pref_ok) {
+    uint64_t xport, xstar;
+    seglSignature(new_segl, xport, xstar);
+    if(!sideMet(xport, xstar))
+      return;
+  }
   
-  m_segl_shortest_star = new_segl;
-  m_dist_shortest_star = new_segl.length();
+  st.segl_shortest_star = new_segl;
+  st.dist_shortest_star = new_segl.length();
+  lowerBound(m_bound_star, st.dist_shortest_star);
 }
 
 
 //---------------------------------------------------------------
 // Procedure: hedgeBestSeglPort()
 
-void PathField::hedgeBestSeglPort()
+void PathField::hedgeBestSeglPort(PathSearchState& st)
 {
-  XYSegList new_segl = simplifySegl(m_segl_shortest_port);
+  XYSegList new_segl = simplifySegl(st, st.segl_shortest_port);
   if(new_segl.size() == 0)
     return;
   
-  string pside = seglPassPoly(m_polys[m_focus_poly], new_segl);
+  string pside = seglPassPoly(m_focus_poly, new_segl);
   if(pside != "port")
     return;
+  if(m_pref_ok) {
+    uint64_t xport, xstar;
+    seglSignature(new_segl, xport, xstar);
+    if(!sideMet(xport, xstar))
+      return;
+  }
   
-  m_segl_shortest_port = new_segl;
-  m_dist_shortest_port = new_segl.length();
+  st.segl_shortest_port = new_segl;
+  st.dist_shortest_port = new_segl.length();
+  lowerBound(m_bound_port, st.dist_shortest_port);
 }
 
 
 //---------------------------------------------------------------
 // Procedure: simplifySegl()
-
-XYSegList PathField::simplifySegl(XYSegList segl)
-{
-  bool done = false;
-  while(!done) {
-    XYSegList new_segl = simplifySeglAux(segl);
-    if(new_segl.size() == 0)
-      done = true;
-    else
-      segl = new_segl;
-  }
-  return(segl);
-}
-
-  
-//---------------------------------------------------------------
-// Procedure: simplifySeglAux()
-
-XYSegList PathField::simplifySeglAux(XYSegList orig_segl)
+//   Purpose: Shorten a free path by greedy line-of-sight shortcuts.
+//            From each kept vertex, jump to the farthest vertex
+//            down the path it can see with a free leg.
+//      Note: Each check is a single indexed segment test, and each
+//            vertex is kept or passed over in a single pass, so at
+//            most n*n/2 tests are made, with far fewer typical.
+
+XYSegList PathField::simplifySegl(PathSearchState& st,
+				  const XYSegList& segl) const
 {
-  XYSegList null_segl;
+  unsigned int vsize = segl.size();
+  if(vsize < 3)
+    return(segl);
 
-  if(orig_segl.size() < 3) 
-    return(null_segl);
+  XYSegList new_segl;
+  unsigned int i = 0;
+  new_segl.add_vertex(segl.get_vx(0), segl.get_vy(0));
+  while(i < vsize-1) {
+    double x1 = segl.get_vx(i);
+    double y1 = segl.get_vy(i);
 
-  for(unsigned int i=1; i<orig_segl.size()-1; i++) {
-    XYSegList segl = orig_segl;
-    segl.delete_vertex(i);
-    if(freeSegl(segl))
-      return(segl);
+    // The next vertex is reachable, the original leg being free
+    unsigned int j = vsize-1;
+    for(; j>i+1; j--) {
+      if(freeSeg(st, x1,y1, segl.get_vx(j),segl.get_vy(j)))
+	break;
+    }
+    new_segl.add_vertex(segl.get_vx(j), segl.get_vy(j));
+    i = j;
   }
-  return(null_segl);
+  return(new_segl);
 }
-
-  
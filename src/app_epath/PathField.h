@@ -13,17 +13,33 @@
 #define PATH_FIELD_HEADER
 
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <functional>
 #include "XYSegList.h"
 #include "XYPolygon.h"
+#include "XYGenPolygon.h"
+#include "VisGraph.h"
+#include "PathSmoother.h"
+#include "ObstacleGrid.h"
+#include "PathNode.h"
+#include "PathSearchState.h"
+#include "DeadPathSink.h"
 
 class PathField {
  public:
   PathField(); 
   ~PathField() {}
 
-  void setSource(double x, double y) {m_sx=x; m_sy=y;}
+  void setSource(double x, double y);
   void setSrcHdg(double hdg)         {m_sh=hdg;}
-  void setDest(double x, double y)   {m_dx=x; m_dy=y;}
+  void setDest(double x, double y);
+
+  void moveSource(double x, double y);
+  void moveDest(double x, double y);
 
   double getSrcX() const  {return(m_sx);}
   double getSrcY() const  {return(m_sy);}
@@ -32,48 +48,196 @@ class PathField {
   double getDestY() const {return(m_dy);}
   
   void   addPoly(XYPolygon);
+  void   addGenPoly(const XYGenPolygon&, std::string label="");
   void   focusPoly(int);
   void   focusPoly(double x, double y);
   void   focusPolyOff();
 
-  void   clearPolys() {m_polys.clear();}
+  void   clearPolys();
+
+  unsigned int mergeObstacles();
+  void   setMergeGap(double v)      {m_merge_gap=(v>0)?v:0;}
+  double getMergeGap() const      {return(m_merge_gap);}
+  void   setMergeHulls(bool v)      {m_merge_hulls=v;}
+  bool   getMergeHulls() const      {return(m_merge_hulls);}
+  void   setNotchDepth(double v)    {m_notch_depth=(v>0)?v:0;}
+  double getNotchDepth() const    {return(m_notch_depth);}
+
   void   clearSolve();
-  void   solve();
+  void   solve(double budget_ms=0);
+  void   prepareSolve(double budget_ms=0);
+  void   runSolve();
+
+  unsigned int solveMany(const std::vector<double>& dest_x,
+			 const std::vector<double>& dest_y,
+			 std::vector<XYSegList>& paths,
+			 std::vector<double>& dists,
+			 std::vector<double>& times_ms);
+  double getManyTreeTime() const {return(m_many_tree_ms);}
+  void   stop() {m_stop = true;}
+
+  typedef std::function<void(const XYSegList&, double)> ProgressCallback;
+
+  void   setProgressCallback(ProgressCallback cb) {m_progress_cb=cb;}
+  bool   getProgress(XYSegList&, double&) const;
+  unsigned int getProgressCount() const {return(m_progress_count);}
+
+  bool   setDeadMode(std::string);
+  std::string getDeadMode() const {return(m_dead_sink.getMode());}
+
+  bool   setSolveMode(std::string);
+  std::string getSolveMode() const {return(m_solve_mode);}
+
+  void   setThreads(unsigned int);
+  unsigned int getThreads() const {return(m_threads);}
+
+  bool   setSearchOrder(std::string);
+  std::string getSearchOrder() const {return(m_search_order);}
+
+  void   setBeamWidth(unsigned int v)  {m_beam_width=(v>0)?v:1;}
+  void   setNodeBudget(unsigned int v) {m_node_budget=v;}
+
+  void   setWarmStart(bool v)       {m_warm_start=v;}
+  bool   getWarmStart() const       {return(m_warm_start);}
 
-  std::vector<XYPolygon> getPolys() const {return(m_polys);}  
-  std::vector<XYSegList> getSeglsDead() const {return(m_segls_dead);}
+  void   setClearance(double);
+  double getClearance() const     {return(m_clearance);}
+  void   setArcTol(double);
+  double getArcTol() const        {return(m_arc_tol);}
 
-  XYSegList   getSeglShortest() const {return(m_segl_shortest);}
-  XYSegList   getSeglShortestPort() const {return(m_segl_shortest_port);}
-  XYSegList   getSeglShortestStar() const {return(m_segl_shortest_star);}
+  void   setTurnRadius(double);
+  double getTurnRadius() const    {return(m_smoother.getTurnRadius());}
 
-  std::string getPolyPassSide(unsigned int);
+  void   setRRTBudget(double ms)    {m_rrt_budget=ms;}
+  double getRRTBudget() const     {return(m_rrt_budget);}
 
-  int getFocusPoly() {return(m_focus_poly);}
+  void   setSeed(unsigned int);
+  unsigned int getSeed() const    {return(m_seed);}
+  std::string  getRunID() const   {return(m_run_id);}
+
+  const std::vector<XYPolygon>& getPolys() const {return(m_polys);}
+  const std::vector<XYPolygon>& getPieces() const {return(m_pieces);}
+  const DeadPathSink& getDeadSink() const {return(m_dead_sink);}
+
+  const XYSegList& getSeglShortest() const {return(m_segl_shortest);}
+  const XYSegList& getSeglShortestPort() const {return(m_segl_shortest_port);}
+  const XYSegList& getSeglShortestStar() const {return(m_segl_shortest_star);}
+  const XYSegList& getSeglSmooth() const {return(m_segl_smooth);}
+
+  std::string getPolyPassSide(unsigned int) const;
+
+  int getFocusPoly() const {return(m_focus_poly);}
+
+  bool   setSidePref(unsigned int ix, std::string side);
+  void   cycleSidePref(double x, double y);
+  void   clearSidePrefs();
+  std::string getSidePref(unsigned int ix) const;
+
+  unsigned int getRevision() const {return(m_revision);}
+
+  unsigned int getCollisionTests() const {return(m_coll_tests);}
   
 private: // Utility functions
-  void solveAux(XYSegList, int depth);
-  void solveAuxSide(XYSegList, int depth, int side);
+  void solveParallel(uint64_t run_seed);
+  void solveWorker(PathSearchState&, std::atomic<unsigned int>& next_leg,
+		   const std::vector<double>& legs_x,
+		   const std::vector<double>& legs_y,
+		   uint64_t run_seed);
+
+  void solveManyWorker(std::atomic<unsigned int>& next_dest,
+		       const std::vector<double>& gcost,
+		       const std::vector<unsigned int>& parent,
+		       const std::vector<double>& dest_x,
+		       const std::vector<double>& dest_y,
+		       std::vector<XYSegList>& paths,
+		       std::vector<double>& dists,
+		       std::vector<double>& times_ms) const;
+
+  void   warmStart(bool src_moved);
+  double repairSegl(PathSearchState&, XYSegList&, bool src_moved) const;
+
+  void initState(PathSearchState&, uint64_t seed) const;
+  void mergeState(PathSearchState&);
+
+  static void lowerBound(std::atomic<double>&, double);
 
-  void genleg(double sx, double sy,
+  bool timeUp(PathSearchState&);
+  void publish(const XYSegList&, double);
+  void resetProgress();
+
+  void solveTree(PathSearchState&, int side);
+  void solveBestFirst(PathSearchState&, int side);
+  void solveBeam(PathSearchState&, int side);
+  void expandNode(PathSearchState&, unsigned int ix, int side);
+
+  void solveAux(PathSearchState&, unsigned int ix, int depth);
+  void solveAuxSide(PathSearchState&, unsigned int ix, int depth, int side);
+  void extendPath(PathSearchState&, unsigned int ix, int depth,
+		  double rx, double ry);
+  void extendPathSide(PathSearchState&, unsigned int ix, int depth,
+		      int side, double rx, double ry);
+
+  void      addDead(PathSearchState&, unsigned int ix,
+		    double rx, double ry, bool wrong_side) const;
+  void      addNode(PathSearchState&, int parent,
+		    double x, double y, double len) const;
+  void      popNodes(PathSearchState&, unsigned int new_size) const;
+  XYSegList seglFromNode(const PathSearchState&, unsigned int ix,
+			 double x, double y) const;
+  void      addChain(const PathSearchState&, unsigned int ix,
+		     XYSegList&) const;
+
+  void        setFocusRays();
+  void        setSideRays();
+  void        legSignature(double x1, double y1, double x2, double y2,
+			   uint64_t& xport, uint64_t& xstar) const;
+  void        seglSignature(const XYSegList&,
+			    uint64_t& xport, uint64_t& xstar) const;
+  bool        sideWrong(uint64_t xport, uint64_t xstar) const;
+  bool        sideMet(uint64_t xport, uint64_t xstar) const;
+  std::string focusPassSide(unsigned int xport, unsigned int xstar) const;
+
+  void   smoothShortest();
+
+  void   solveRRT(uint64_t run_seed, double budget_ms);
+  void   solveVGraph();
+  double solveVGraphSide(VisGraph&, int side, XYSegList&);
+
+  void genleg(PathSearchState&, double sx, double sy,
 	      double dx, double dy,
 	      double angrng, double distrng,
-	      double& rx, double& ry);
+	      double& rx, double& ry) const;
+
+  bool freeSeg(PathSearchState&, double sx, double sy,
+	       double dx, double dy) const;
+  bool freeSegl(PathSearchState&, const XYSegList&) const;
 
-  bool freeSeg(double sx, double sy, double dx, double dy);
-  bool freeSegl(const XYSegList&);
-  bool fullSegl(XYSegList);
+  std::string seglPassPoly(unsigned int ix, const XYSegList& segl) const;
+  void anchorRays(unsigned int ix, double sx, double sy,
+		  double& port_x, double& port_y, double& port_hdg,
+		  double& star_x, double& star_y, double& star_hdg) const;
+  void rayExit(const XYPolygon&, double px, double py, double ph,
+	       double& ex, double& ey) const;
 
-  std::string seglPassPoly(XYPolygon poly, XYSegList segl); 
+  void addOutline(const XYPolygon&, const std::vector<XYPolygon>& pieces);
+  void addPiece(const XYPolygon&, unsigned int owner);
+  bool piecesNear(const XYPolygon&, const XYPolygon&, double gap) const;
+  bool coverOutline(const XYPolygon&, std::vector<XYPolygon>&) const;
+  bool holdsEndpoint(const XYPolygon&) const;
+  void reinflate();
+  XYPolygon inflatePiece(const XYPolygon&) const;
+  int  polyAt(double x, double y) const;
 
-  unsigned int crossRaySegl(double, double, double, const XYSegList&);
+  unsigned int crossRaySegl(double, double, double, const XYSegList&) const;
+  unsigned int crossRaySeg(double px, double py, double ph,
+			   double x1, double y1,
+			   double x2, double y2) const;
 
-  XYSegList simplifySegl(XYSegList segl);
-  XYSegList simplifySeglAux(XYSegList segl);
+  XYSegList simplifySegl(PathSearchState&, const XYSegList&) const;
 
-  void hedgeBestSegl();
-  void hedgeBestSeglStar();
-  void hedgeBestSeglPort();
+  void hedgeBestSegl(PathSearchState&);
+  void hedgeBestSeglStar(PathSearchState&);
+  void hedgeBestSeglPort(PathSearchState&);
 
   
 protected: // state vars
@@ -83,7 +247,21 @@ protected: // state vars
   double m_dx;
   double m_dy;
 
-  std::vector<XYPolygon> m_polys;
+  // Obstacle outlines, as added, and the convex pieces they are
+  // made of. A convex poly is its own single piece, a non-convex
+  // one is split by its genpoly cover. Collision checks are made
+  // on the pieces as inflated by the clearance.
+  std::vector<XYPolygon>    m_polys;
+  std::vector<XYPolygon>    m_raw_pieces;
+  std::vector<XYPolygon>    m_pieces;
+  std::vector<unsigned int> m_piece_owner;
+
+  // Origin of the side rays of each obstacle, inside it: the center
+  // of a convex poly, or of the largest cover piece otherwise
+  std::vector<double> m_anchor_x;
+  std::vector<double> m_anchor_y;
+  std::vector<bool>   m_anchor_ok;
+
   std::vector<XYSegList> m_poly_star;
   std::vector<XYSegList> m_poly_port;
   
@@ -96,15 +274,108 @@ protected: // state vars
   XYSegList m_segl_shortest_port;
   double    m_dist_shortest_port;
 
+  // The shortest path as flown with the turn radius, from the
+  // source heading. Empty if smoothing is off or failed.
+  XYSegList    m_segl_smooth;
+  PathSmoother m_smoother;
+
   
   
-  std::vector<XYSegList> m_segls_dead;
+  DeadPathSink m_dead_sink;
 
   int m_focus_poly;
+
+  // Bumped on any change to the polys, focus or solution
+  unsigned int m_revision;
+
+  // Visibility graph over m_polys, kept across solves until the
+  // polys change
+  VisGraph m_vgraph;
+  bool     m_vgraph_ok;
+
+  // Time (ms) to grow the shortest path tree in the last solveMany
+  double   m_many_tree_ms;
+
+  // Spatial index over m_pieces for collision checks
+  ObstacleGrid m_obs_grid;
+
+  // Segment tests made by the last solve, over all threads
+  unsigned int m_coll_tests;
+
+  // Best distances so far during a solve, shared by all threads
+  // for pruning, -1 if none yet
+  std::atomic<double> m_bound_shortest;
+  std::atomic<double> m_bound_port;
+  std::atomic<double> m_bound_star;
+
+  // Number of random searches since seeding, and the ID of the
+  // last one, as <seed>.<run>
+  unsigned int m_run_count;
+  std::string  m_run_id;
+
+  // Deadline of the solve in progress, if it has a budget, and
+  // the flag telling all threads to wind up
+  bool m_deadline_on;
+  std::chrono::steady_clock::time_point m_deadline;
+  double m_budget_ms;
+  std::atomic<bool> m_stop;
+
+  // Best path published so far during a solve, readable from
+  // other threads while the solve runs
+  mutable std::mutex        m_progress_mutex;
+  XYSegList                 m_progress_segl;
+  double                    m_progress_dist;
+  std::atomic<unsigned int> m_progress_count;
+  ProgressCallback          m_progress_cb;
+
+  // Port and starboard rays of the focus poly for this solve,
+  // each from where it leaves the poly border for good
+  bool   m_focus_ok;
+  double m_focus_port_x;
+  double m_focus_port_y;
+  double m_focus_port;
+  double m_focus_star_x;
+  double m_focus_star_y;
+  double m_focus_star;
+
+  // Side preferences, at most 64 at once: the poly of each slot,
+  // and bit k of the masks set if slot k is to be passed on port
+  // (star). A slot with neither bit set is free for reuse
+  std::vector<unsigned int> m_pref_polys;
+  uint64_t m_pref_port;
+  uint64_t m_pref_star;
+
+  // Rays of the side-preference polys for this solve, as the line
+  // through the anchor along the port heading, with the port ray
+  // beyond port_u and the star ray before star_u along it. Bit k
+  // of m_pref_ok set if poly k has an anchor inside, so its side
+  // can be judged, and the port (star) masks of the judged polys
+  std::vector<double> m_pref_ax;
+  std::vector<double> m_pref_ay;
+  std::vector<double> m_pref_ux;
+  std::vector<double> m_pref_uy;
+  std::vector<double> m_pref_port_u;
+  std::vector<double> m_pref_star_u;
+  uint64_t m_pref_ok;
+  uint64_t m_need_port;
+  uint64_t m_need_star;
   
 protected: // config vars
 
   unsigned int m_branches;  
+  unsigned int m_threads;
+  unsigned int m_seed;
+  std::string  m_solve_mode;
+  std::string  m_search_order; // depth, best or beam
+  unsigned int m_beam_width;
+  unsigned int m_node_budget;  // Max tree nodes in best/beam order
+  bool         m_warm_start;  // Repair the last paths on src/dest moves
+  double       m_rrt_budget;  // Budget (ms) in rrt mode if none given
+  double       m_clearance;   // Distance kept from all obstacles
+  double       m_arc_tol;     // Max standoff of inflated corners
+  double       m_merge_gap;   // Obstacles closer than this are merged
+  bool         m_merge_hulls; // Merge groups with no one outline to a hull
+  double       m_notch_depth; // Merged outline notches filled up to this
 };
 
 
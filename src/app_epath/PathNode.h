@@ -0,0 +1,40 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: PathNode.h                                           */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef PATH_NODE_HEADER
+#define PATH_NODE_HEADER
+
+#include <cstdint>
+
+//---------------------------------------------------------------
+// One vertex of a partial path in the PathField search tree. The
+// path to a node is found by following parent indices back to
+// the root. Each node also carries what is needed to judge the
+// path so far: its length, the number of times it crosses the
+// port and starboard rays of the focus poly, and which rays of the
+// side-preference polys it has crossed.
+
+struct PathNode {
+  int    parent;   // Index of the parent node, -1 for the root
+  double x;
+  double y;
+  double len;      // Path length from the root to this node
+
+  unsigned int xport;
+  unsigned int xstar;
+
+  // Bit k set if the path has crossed the port (star) ray of side
+  // preference poly k
+  uint64_t xport_bits;
+  uint64_t xstar_bits;
+};
+
+#endif
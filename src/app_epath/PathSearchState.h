@@ -0,0 +1,59 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: PathSearchState.h                                    */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef PATH_SEARCH_STATE_HEADER
+#define PATH_SEARCH_STATE_HEADER
+
+#include <vector>
+#include <utility>
+#include "XYSegList.h"
+#include "PathNode.h"
+#include "RandGen.h"
+#include "DeadPathSink.h"
+
+//---------------------------------------------------------------
+// Everything one thread of the PathField random search writes
+// to: its node arena, scratch space, random number state, dead
+// path record and the best paths it has found. Each worker has its own,
+// and they are merged into the PathField when the search is done.
+
+struct PathSearchState {
+  // Arena of search tree nodes, used as a stack: the nodes on the
+  // path currently being extended, root first, and that path as
+  // a seglist
+  std::vector<PathNode> nodes;
+  XYSegList             path_segl;
+
+  // In best-first and beam order the arena holds a whole tree,
+  // not just the current path, and path_segl is not kept. Nodes
+  // waiting to be expanded are held in open as (lower bound on
+  // full path length, node index).
+  bool tree;
+  std::vector<std::pair<double, unsigned int> > open;
+
+  // Scratch space for obstacle grid queries
+  std::vector<unsigned int> obs_cands;
+
+  RandGen      rng;
+  unsigned int coll_tests;
+  unsigned int ticks;     // Calls since the clock was last read
+
+  DeadPathSink dead_sink;
+
+  XYSegList segl_shortest;
+  double    dist_shortest;
+  XYSegList segl_shortest_port;
+  double    dist_shortest_port;
+  XYSegList segl_shortest_star;
+  double    dist_shortest_star;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: PathSmoother.cpp                                     */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include "PathSmoother.h"
+#include "MBUtils.h"
+#include "AngleUtils.h"
+#include "XYSeglr.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+PathSmoother::PathSmoother()
+{
+  // Init config vars
+  m_turn_radius = 0;
+  m_spoke_degs  = 10;
+}
+
+//---------------------------------------------------------------
+// Procedure: setSpokeDegs()
+//      Note: Cached turn models were made with the old spoke
+//            spacing, so are dropped.
+
+void PathSmoother::setSpokeDegs(double degs)
+{
+  if((degs < 1) || (degs == m_spoke_degs))
+    return;
+  m_spoke_degs = degs;
+  m_models.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: smooth()
+//   Purpose: Build the turn-limited path through the waypoints of
+//            the given path, leaving its first vertex on the given
+//            heading.
+//   Returns: true if every waypoint could be reached by a turn and
+//            leg free of the obstacles. Otherwise the result is
+//            left empty.
+
+bool PathSmoother::smooth(const XYSegList& path, double hdg,
+			  const vector<XYPolygon>& polys,
+			  const ObstacleGrid& obs_grid, XYSegList& result)
+{
+  result.clear();
+  if((m_turn_radius <= 0) || (path.size() < 2))
+    return(false);
+
+  double px = path.get_vx(0);
+  double py = path.get_vy(0);
+  double ph = angle360(hdg);
+  result.add_vertex(px, py);
+
+  for(unsigned int i=1; i<path.size(); i++) {
+    double wx = path.get_vx(i);
+    double wy = path.get_vy(i);
+    if(hypot(wx-px, wy-py) < 1e-6)
+      continue;
+
+    XYSegList leg;
+    double leg_hdg;
+    if(!turnLeg(px, py, ph, wx, wy, leg, leg_hdg) ||
+       !freeSegl(leg, polys, obs_grid)) {
+      result.clear();
+      return(false);
+    }
+    for(unsigned int j=1; j<leg.size(); j++)
+      result.add_vertex(leg.get_vx(j), leg.get_vy(j));
+
+    px = wx;
+    py = wy;
+    ph = leg_hdg;
+  }
+
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: turnLeg()
+//   Purpose: Find the turn from pose x,y,hdg after which a straight
+//            leg reaches wx,wy. The end of the turn depends on the
+//            heading turned to, so the heading is found by fixed
+//            point iteration, starting from the direct bearing.
+//   Returns: false if no turn reaches the waypoint, e.g., if it is
+//            inside the turn circle. Otherwise the leg from the
+//            pose to the waypoint, and the heading it ends on.
+
+bool PathSmoother::turnLeg(double x, double y, double hdg,
+			   double wx, double wy, XYSegList& leg,
+			   double& leg_hdg)
+{
+  const PlatModel& model = turnModel();
+
+  leg_hdg = relAng(x, y, wx, wy);
+  for(unsigned int i=0; i<20; i++) {
+    // Turn from the model at the origin heading north, then moved
+    // onto the pose
+    XYSeglr seglr = model.getTurnSeglr(angle360(leg_hdg - hdg));
+    XYSegList turn = seglr.getBaseSegList();
+    turn.rotate(hdg, 0, 0);
+    turn.shift_horz(x);
+    turn.shift_vert(y);
+
+    double bx = x;
+    double by = y;
+    if(turn.size() > 0) {
+      bx = turn.get_vx(turn.size()-1);
+      by = turn.get_vy(turn.size()-1);
+    }
+    if(hypot(wx-bx, wy-by) < 1e-6)
+      return(false);
+
+    double ray_hdg = angle360(seglr.getRayAngle() + hdg);
+    double to_wpt = relAng(bx, by, wx, wy);
+    double delta = angle180(to_wpt - ray_hdg);
+    if(fabs(delta) < 0.5) {
+      leg.clear();
+      leg.add_vertex(x, y);
+      for(unsigned int j=0; j<turn.size(); j++) {
+	double tx = turn.get_vx(j);
+	double ty = turn.get_vy(j);
+	if(hypot(tx-x, ty-y) > 1e-6)
+	  leg.add_vertex(tx, ty);
+      }
+      leg.add_vertex(wx, wy);
+      leg_hdg = to_wpt;
+      return(true);
+    }
+    leg_hdg = angle360(leg_hdg + delta);
+  }
+  return(false);
+}
+
+//---------------------------------------------------------------
+// Procedure: turnModel()
+//   Purpose: The platform model for the current turn radius, at
+//            the origin heading north, generated on first use.
+
+const PlatModel& PathSmoother::turnModel()
+{
+  map<double, PlatModel>::iterator p = m_models.find(m_turn_radius);
+  if(p != m_models.end())
+    return(p->second);
+
+  m_pmgen.setParam("radius", doubleToString(m_turn_radius));
+  m_pmgen.setParam("spoke_degs", doubleToString(m_spoke_degs));
+  m_models[m_turn_radius] = m_pmgen.generate(0, 0, 0, 1);
+  return(m_models[m_turn_radius]);
+}
+
+//---------------------------------------------------------------
+// Procedure: freeSegl()
+//      Note: Only obstacles near each segment, per the obstacle
+//            grid, are given the exact intersection test.
+
+bool PathSmoother::freeSegl(const XYSegList& segl,
+			    const vector<XYPolygon>& polys,
+			    const ObstacleGrid& obs_grid)
+{
+  for(unsigned int i=0; (i+1)<segl.size(); i++) {
+    double x1 = segl.get_vx(i);
+    double y1 = segl.get_vy(i);
+    double x2 = segl.get_vx(i+1);
+    double y2 = segl.get_vy(i+1);
+    obs_grid.segCandidates(x1,y1, x2,y2, m_obs_cands);
+    for(unsigned int j=0; j<m_obs_cands.size(); j++) {
+      if(polys[m_obs_cands[j]].seg_intercepts(x1,y1, x2,y2))
+	return(false);
+    }
+  }
+  return(true);
+}
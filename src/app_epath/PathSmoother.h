@@ -0,0 +1,71 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: PathSmoother.h                                       */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef PATH_SMOOTHER_HEADER
+#define PATH_SMOOTHER_HEADER
+
+#include <map>
+#include <vector>
+#include "XYSegList.h"
+#include "XYPolygon.h"
+#include "PMGen_Dubins.h"
+#include "PlatModel.h"
+#include "ObstacleGrid.h"
+
+//---------------------------------------------------------------
+// Turns a polyline path into one a vehicle with a minimum turn
+// radius can follow. Starting from the source heading, each
+// waypoint is reached by a turn of the given radius followed by
+// a straight leg (a Dubins CS path), and the vehicle leaves it on
+// that leg's heading. The turns are those of PMGen_Dubins. The
+// PlatModel is generated once per radius at the origin, heading
+// north, and each turn is taken from it and moved to the pose.
+// Turns leave the polyline on the outside of each corner, so the
+// corners still clear the obstacles they wrap, and every arc and
+// leg is checked against the obstacles anyway.
+
+class PathSmoother {
+ public:
+  PathSmoother();
+  ~PathSmoother() {}
+
+  void   setTurnRadius(double v) {if(v >= 0) m_turn_radius = v;}
+  void   setSpokeDegs(double);
+
+  double getTurnRadius() const {return(m_turn_radius);}
+  double getSpokeDegs() const  {return(m_spoke_degs);}
+
+  bool   smooth(const XYSegList& path, double hdg,
+		const std::vector<XYPolygon>& polys,
+		const ObstacleGrid& obs_grid, XYSegList& result);
+
+  unsigned int getCacheSize() const {return(m_models.size());}
+
+ protected:
+  bool   turnLeg(double x, double y, double hdg,
+		 double wx, double wy, XYSegList& leg, double& leg_hdg);
+  const PlatModel& turnModel();
+
+  bool   freeSegl(const XYSegList&, const std::vector<XYPolygon>& polys,
+		  const ObstacleGrid& obs_grid);
+
+ protected: // State vars
+  std::map<double, PlatModel> m_models;
+  std::vector<unsigned int>   m_obs_cands;
+
+  PMGen_Dubins m_pmgen;
+
+ protected: // Config vars
+  double m_turn_radius;
+  double m_spoke_degs;
+};
+
+#endif
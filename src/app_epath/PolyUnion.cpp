@@ -0,0 +1,431 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: PolyUnion.cpp                                        */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include "PolyUnion.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+PolyUnion::PolyUnion()
+{
+  // Init config vars
+  m_tol = 1e-6;
+  m_kept_holes = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: addPoly()
+//      Note: Vertices are stored counter-clockwise, so the outside
+//            of every edge is to its right.
+
+void PolyUnion::addPoly(const XYPolygon& poly)
+{
+  unsigned int vsize = poly.size();
+  if(vsize < 3)
+    return;
+
+  double area2 = 0;
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int j = (i+1) % vsize;
+    area2 += poly.get_vx(i) * poly.get_vy(j);
+    area2 -= poly.get_vx(j) * poly.get_vy(i);
+  }
+
+  vector<double> px(vsize), py(vsize);
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int k = (area2 > 0) ? i : (vsize-1-i);
+    px[i] = poly.get_vx(k);
+    py[i] = poly.get_vy(k);
+  }
+  m_px.push_back(px);
+  m_py.push_back(py);
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void PolyUnion::clear()
+{
+  m_px.clear();
+  m_py.clear();
+  m_vx.clear();
+  m_vy.clear();
+  m_edge_from.clear();
+  m_edge_to.clear();
+  m_out.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: addKeepPoint()
+
+void PolyUnion::addKeepPoint(double x, double y)
+{
+  m_keep_x.push_back(x);
+  m_keep_y.push_back(y);
+}
+
+//---------------------------------------------------------------
+// Procedure: clearKeepPoints()
+
+void PolyUnion::clearKeepPoints()
+{
+  m_keep_x.clear();
+  m_keep_y.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: getOutlines()
+//   Purpose: Build the outer borders of the union.
+
+vector<XYPolygon> PolyUnion::getOutlines()
+{
+  m_vx.clear();
+  m_vy.clear();
+  m_edge_from.clear();
+  m_edge_to.clear();
+  m_out.clear();
+  m_kept_holes = 0;
+
+  // Part 1: Split every edge and keep the pieces on the border
+  for(unsigned int i=0; i<m_px.size(); i++) {
+    for(unsigned int j=0; j<m_px[i].size(); j++)
+      splitEdge(i, j);
+  }
+
+  // Part 2: Chain the kept pieces into loops
+  vector<XYPolygon> outlines;
+  vector<bool> used(m_edge_from.size(), false);
+  for(unsigned int e=0; e<m_edge_from.size(); e++) {
+    if(used[e])
+      continue;
+
+    vector<unsigned int> loop;
+    unsigned int start = m_edge_from[e];
+    unsigned int curr = e;
+    used[e] = true;
+    loop.push_back(start);
+    bool closed = false;
+    while(!closed) {
+      unsigned int vix = m_edge_to[curr];
+      if(vix == start) {
+	closed = true;
+	break;
+      }
+      loop.push_back(vix);
+
+      // Of the unused pieces leaving this vertex, take the one
+      // turning most to the left
+      double hdg = atan2(m_vy[vix]-m_vy[m_edge_from[curr]],
+			 m_vx[vix]-m_vx[m_edge_from[curr]]);
+      int next = -1;
+      double next_turn = 0;
+      for(unsigned int k=0; k<m_out[vix].size(); k++) {
+	unsigned int cand = m_out[vix][k];
+	if(used[cand])
+	  continue;
+	unsigned int tix = m_edge_to[cand];
+	double turn = atan2(m_vy[tix]-m_vy[vix], m_vx[tix]-m_vx[vix]) - hdg;
+	while(turn > M_PI)
+	  turn -= 2 * M_PI;
+	while(turn <= -M_PI)
+	  turn += 2 * M_PI;
+	if((next < 0) || (turn > next_turn)) {
+	  next = cand;
+	  next_turn = turn;
+	}
+      }
+      if(next < 0)
+	break;
+      curr = next;
+      used[curr] = true;
+    }
+    if(!closed)
+      continue;
+
+    // Drop vertices where the border runs straight on, left by
+    // the edge splits
+    vector<unsigned int> corners;
+    unsigned int lsize = loop.size();
+    for(unsigned int k=0; k<lsize; k++) {
+      unsigned int a = loop[(k+lsize-1) % lsize];
+      unsigned int b = loop[k];
+      unsigned int c = loop[(k+1) % lsize];
+      double cross = ((m_vx[b]-m_vx[a]) * (m_vy[c]-m_vy[b]) -
+		      (m_vy[b]-m_vy[a]) * (m_vx[c]-m_vx[b]));
+      double len = hypot(m_vx[b]-m_vx[a], m_vy[b]-m_vy[a]) +
+	hypot(m_vx[c]-m_vx[b], m_vy[c]-m_vy[b]);
+      if(fabs(cross) > (m_tol * len))
+	corners.push_back(b);
+    }
+    if(corners.size() < 3)
+      continue;
+
+    double area2 = 0;
+    for(unsigned int k=0; k<corners.size(); k++) {
+      unsigned int a = corners[k];
+      unsigned int b = corners[(k+1) % corners.size()];
+      area2 += m_vx[a] * m_vy[b] - m_vx[b] * m_vy[a];
+    }
+    if(area2 <= 0) {
+      for(unsigned int k=0; k<m_keep_x.size(); k++) {
+	if(loopHolds(corners, m_keep_x[k], m_keep_y[k])) {
+	  m_kept_holes++;
+	  break;
+	}
+      }
+      continue;
+    }
+
+    XYPolygon outline;
+    for(unsigned int k=0; k<corners.size(); k++)
+      outline.add_vertex(m_vx[corners[k]], m_vy[corners[k]], false);
+    outline.determine_convexity();
+    outlines.push_back(outline);
+  }
+
+  return(outlines);
+}
+
+//---------------------------------------------------------------
+// Procedure: fillNotches()
+//   Purpose: Drop the concave vertices of a counter-clockwise
+//            outline that lie within max_depth of the line joining
+//            their neighbors, so long as no other vertex lies in
+//            the notch. Repeated until none is left, since each
+//            drop may leave a new shallow notch.
+//      Note: A notch holding a keep point is left open, since the
+//            point would otherwise end up inside the outline.
+//      Note: A path from outside could only enter such a notch and
+//            leave it by the same opening, so no shortest path
+//            from outside is made longer.
+
+XYPolygon PolyUnion::fillNotches(const XYPolygon& poly, double max_depth) const
+{
+  vector<double> vx, vy;
+  for(unsigned int i=0; i<poly.size(); i++) {
+    vx.push_back(poly.get_vx(i));
+    vy.push_back(poly.get_vy(i));
+  }
+
+  bool filled = true;
+  while(filled && (vx.size() > 3)) {
+    filled = false;
+    unsigned int vsize = vx.size();
+    for(unsigned int i=0; (i<vsize) && !filled; i++) {
+      unsigned int h = (i+vsize-1) % vsize;
+      unsigned int j = (i+1) % vsize;
+      double ux = vx[j] - vx[h];
+      double uy = vy[j] - vy[h];
+      double len = hypot(ux, uy);
+      if(len <= m_tol)
+	continue;
+
+      // Concave vertices are left of the line joining neighbors
+      double cross = ux * (vy[i]-vy[h]) - uy * (vx[i]-vx[h]);
+      if((cross <= 0) || ((cross / len) > max_depth))
+	continue;
+
+      bool empty = true;
+      for(unsigned int k=0; (k<vsize) && empty; k++) {
+	if((k == h) || (k == i) || (k == j))
+	  continue;
+	double c1 = (vx[i]-vx[h]) * (vy[k]-vy[h]) - (vy[i]-vy[h]) * (vx[k]-vx[h]);
+	double c2 = (vx[j]-vx[i]) * (vy[k]-vy[i]) - (vy[j]-vy[i]) * (vx[k]-vx[i]);
+	double c3 = (vx[h]-vx[j]) * (vy[k]-vy[j]) - (vy[h]-vy[j]) * (vx[k]-vx[j]);
+	empty = !((c1 <= 0) && (c2 <= 0) && (c3 <= 0));
+      }
+      for(unsigned int k=0; (k<m_keep_x.size()) && empty; k++) {
+	double kx = m_keep_x[k];
+	double ky = m_keep_y[k];
+	double c1 = (vx[i]-vx[h]) * (ky-vy[h]) - (vy[i]-vy[h]) * (kx-vx[h]);
+	double c2 = (vx[j]-vx[i]) * (ky-vy[i]) - (vy[j]-vy[i]) * (kx-vx[i]);
+	double c3 = (vx[h]-vx[j]) * (ky-vy[j]) - (vy[h]-vy[j]) * (kx-vx[j]);
+	empty = !((c1 <= 0) && (c2 <= 0) && (c3 <= 0));
+      }
+      if(!empty)
+	continue;
+
+      vx.erase(vx.begin() + i);
+      vy.erase(vy.begin() + i);
+      filled = true;
+    }
+  }
+
+  XYPolygon result;
+  for(unsigned int i=0; i<vx.size(); i++)
+    result.add_vertex(vx[i], vy[i], false);
+  result.determine_convexity();
+  result.set_label(poly.get_label());
+  return(result);
+}
+
+//---------------------------------------------------------------
+// Procedure: loopHolds()
+//   Purpose: Determine if a point is inside a loop of vertices, of
+//            either direction, by the crossing rule.
+
+bool PolyUnion::loopHolds(const vector<unsigned int>& loop,
+			  double px, double py) const
+{
+  bool inside = false;
+  unsigned int lsize = loop.size();
+  for(unsigned int k=0; k<lsize; k++) {
+    double x1 = m_vx[loop[k]];
+    double y1 = m_vy[loop[k]];
+    double x2 = m_vx[loop[(k+1) % lsize]];
+    double y2 = m_vy[loop[(k+1) % lsize]];
+    if((y1 > py) == (y2 > py))
+      continue;
+    double ix = x1 + (py - y1) * (x2 - x1) / (y2 - y1);
+    if(px < ix)
+      inside = !inside;
+  }
+  return(inside);
+}
+
+//---------------------------------------------------------------
+// Procedure: splitEdge()
+//   Purpose: Split edge eix of poly pix where it meets the edges
+//            of the other polys, and keep the pieces that lie on
+//            the border of the union.
+
+void PolyUnion::splitEdge(unsigned int pix, unsigned int eix)
+{
+  unsigned int vsize = m_px[pix].size();
+  double ax = m_px[pix][eix];
+  double ay = m_py[pix][eix];
+  double bx = m_px[pix][(eix+1) % vsize];
+  double by = m_py[pix][(eix+1) % vsize];
+  double rx = bx - ax;
+  double ry = by - ay;
+  double len = hypot(rx, ry);
+  if(len <= m_tol)
+    return;
+
+  vector<double> splits;
+  splits.push_back(0);
+  splits.push_back(1);
+
+  for(unsigned int i=0; i<m_px.size(); i++) {
+    if(i == pix)
+      continue;
+    unsigned int isize = m_px[i].size();
+    for(unsigned int j=0; j<isize; j++) {
+      double cx = m_px[i][j];
+      double cy = m_py[i][j];
+      double sx = m_px[i][(j+1) % isize] - cx;
+      double sy = m_py[i][(j+1) % isize] - cy;
+
+      double denom = rx*sy - ry*sx;
+      double qx = cx - ax;
+      double qy = cy - ay;
+      if(fabs(denom) > (m_tol * len * hypot(sx, sy))) {
+	double t = (qx*sy - qy*sx) / denom;
+	double u = (qx*ry - qy*rx) / denom;
+	if((t > 0) && (t < 1) && (u >= 0) && (u <= 1))
+	  splits.push_back(t);
+      }
+      else if(fabs(qx*ry - qy*rx) <= (m_tol * len)) {
+	// Collinear edges: split at the other edge's end points
+	double t1 = (qx*rx + qy*ry) / (len * len);
+	double t2 = ((qx+sx)*rx + (qy+sy)*ry) / (len * len);
+	if((t1 > 0) && (t1 < 1))
+	  splits.push_back(t1);
+	if((t2 > 0) && (t2 < 1))
+	  splits.push_back(t2);
+      }
+    }
+  }
+  sort(splits.begin(), splits.end());
+
+  // A piece is on the border if a point just outside it, to its
+  // right, is outside all the other polys
+  double nx = ry / len;
+  double ny = -rx / len;
+  double offset = 100 * m_tol;
+  for(unsigned int k=0; (k+1)<splits.size(); k++) {
+    double t1 = splits[k];
+    double t2 = splits[k+1];
+    if(((t2 - t1) * len) <= m_tol)
+      continue;
+    double mx = ax + rx * (t1+t2)/2 + nx * offset;
+    double my = ay + ry * (t1+t2)/2 + ny * offset;
+    if(insideOther(mx, my, pix))
+      continue;
+    unsigned int from = vertexID(ax + rx*t1, ay + ry*t1);
+    unsigned int to   = vertexID(ax + rx*t2, ay + ry*t2);
+    if(from != to)
+      addEdge(from, to);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: addEdge()
+//      Note: The same piece may come from two polys sharing an
+//            edge, and is kept once.
+
+void PolyUnion::addEdge(unsigned int from, unsigned int to)
+{
+  for(unsigned int k=0; k<m_out[from].size(); k++) {
+    if(m_edge_to[m_out[from][k]] == to)
+      return;
+  }
+  m_out[from].push_back(m_edge_from.size());
+  m_edge_from.push_back(from);
+  m_edge_to.push_back(to);
+}
+
+//---------------------------------------------------------------
+// Procedure: insideOther()
+//   Purpose: Determine if px,py is strictly inside any poly other
+//            than poly pix, i.e., left of all its edges.
+
+bool PolyUnion::insideOther(double px, double py, unsigned int pix) const
+{
+  for(unsigned int i=0; i<m_px.size(); i++) {
+    if(i == pix)
+      continue;
+    unsigned int isize = m_px[i].size();
+    bool inside = true;
+    for(unsigned int j=0; (j<isize) && inside; j++) {
+      unsigned int k = (j+1) % isize;
+      double cross = ((m_px[i][k]-m_px[i][j]) * (py-m_py[i][j]) -
+		      (m_py[i][k]-m_py[i][j]) * (px-m_px[i][j]));
+      inside = (cross > 0);
+    }
+    if(inside)
+      return(true);
+  }
+  return(false);
+}
+
+//---------------------------------------------------------------
+// Procedure: vertexID()
+//   Purpose: Index of the vertex at x,y, added if none is within
+//            the tolerance, so that split points met from either
+//            of two crossing edges are one vertex.
+
+unsigned int PolyUnion::vertexID(double x, double y)
+{
+  double tol = 10 * m_tol;
+  for(unsigned int i=0; i<m_vx.size(); i++) {
+    if((fabs(m_vx[i]-x) <= tol) && (fabs(m_vy[i]-y) <= tol))
+      return(i);
+  }
+  m_vx.push_back(x);
+  m_vy.push_back(y);
+  m_out.push_back(vector<unsigned int>());
+  return(m_vx.size()-1);
+}
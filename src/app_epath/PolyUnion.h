@@ -0,0 +1,82 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: PolyUnion.h                                          */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef POLY_UNION_HEADER
+#define POLY_UNION_HEADER
+
+#include <vector>
+#include "XYPolygon.h"
+
+//---------------------------------------------------------------
+// Outline of the union of a set of convex polygons. Each edge,
+// taken counter-clockwise, is split wherever it meets an edge of
+// another polygon, and a piece is kept only if the point just to
+// its right (outside its own polygon) is outside all the others.
+// Kept pieces are chained into loops. Counter-clockwise loops are
+// outer borders, clockwise ones are holes and are dropped, since
+// no path from outside can reach them. A hole holding a keep point
+// is counted, see getKeptHoles(), so that the caller can decline
+// to fill it. Where two borders touch
+// at a point, the sharpest left turn is taken, so each loop comes
+// out simple and touching shapes give separate loops. Shallow
+// notches left in an outline where shapes overlap may be filled,
+// since a shortest path from outside never enters a notch. A
+// notch holding a keep point, e.g., a path source or destination,
+// is never filled.
+
+class PolyUnion {
+ public:
+  PolyUnion();
+  ~PolyUnion() {}
+
+  void   setTolerance(double v) {if(v > 0) m_tol = v;}
+  void   addKeepPoint(double x, double y);
+  void   clearKeepPoints();
+  void   addPoly(const XYPolygon&);
+  void   clear();
+
+  std::vector<XYPolygon> getOutlines();
+  unsigned int getKeptHoles() const {return(m_kept_holes);}
+
+  XYPolygon fillNotches(const XYPolygon&, double max_depth) const;
+
+ protected:
+  void   splitEdge(unsigned int pix, unsigned int eix);
+  void   addEdge(unsigned int from, unsigned int to);
+  bool   insideOther(double px, double py, unsigned int pix) const;
+  bool   loopHolds(const std::vector<unsigned int>& loop,
+		   double px, double py) const;
+  unsigned int vertexID(double x, double y);
+
+ protected: // State vars
+  // Input polys, as counter-clockwise vertex lists
+  std::vector<std::vector<double> > m_px;
+  std::vector<std::vector<double> > m_py;
+
+  // Vertices of the kept edge pieces, the pieces as vertex pairs,
+  // and the pieces leaving each vertex
+  std::vector<double> m_vx;
+  std::vector<double> m_vy;
+  std::vector<unsigned int> m_edge_from;
+  std::vector<unsigned int> m_edge_to;
+  std::vector<std::vector<unsigned int> > m_out;
+
+  // Holes of the last union holding a keep point
+  unsigned int m_kept_holes;
+
+ protected: // Config vars
+  double m_tol;
+
+  std::vector<double> m_keep_x;
+  std::vector<double> m_keep_y;
+};
+
+#endif
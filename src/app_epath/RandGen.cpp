@@ -0,0 +1,64 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: RandGen.cpp                                          */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include "RandGen.h"
+
+//---------------------------------------------------------------
+// Procedure: rotl()
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+  return((x << k) | (x >> (64 - k)));
+}
+
+//---------------------------------------------------------------
+// Procedure: setSeed()
+//      Note: Filled by splitmix64, making the all-zero state, the
+//            one state xoshiro cannot leave, practically impossible.
+
+void RandGen::setSeed(uint64_t seed)
+{
+  uint64_t z = seed;
+  for(unsigned int i=0; i<4; i++) {
+    z += 0x9e3779b97f4a7c15ULL;
+    uint64_t v = z;
+    v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    v = (v ^ (v >> 27)) * 0x94d049bb133111ebULL;
+    m_s[i] = v ^ (v >> 31);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: next()
+
+uint64_t RandGen::next()
+{
+  uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+  uint64_t t = m_s[1] << 17;
+
+  m_s[2] ^= m_s[0];
+  m_s[3] ^= m_s[1];
+  m_s[1] ^= m_s[2];
+  m_s[0] ^= m_s[3];
+  m_s[2] ^= t;
+  m_s[3] = rotl(m_s[3], 45);
+
+  return(result);
+}
+
+//---------------------------------------------------------------
+// Procedure: uniform()
+//   Returns: A value in [0,1) from the top 53 bits of next()
+
+double RandGen::uniform()
+{
+  return((double)(next() >> 11) * (1.0 / 9007199254740992.0));
+}
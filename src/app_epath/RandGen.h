@@ -0,0 +1,37 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: RandGen.h                                            */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef RAND_GEN_HEADER
+#define RAND_GEN_HEADER
+
+#include <cstdint>
+
+//---------------------------------------------------------------
+// Small, fast pseudo-random generator (xoshiro256**) with its own
+// state, so each search or thread can hold one and replay the
+// same sequence from the same seed. The state is filled from the
+// seed by splitmix64, so nearby seeds give unrelated sequences.
+
+class RandGen {
+ public:
+  RandGen(uint64_t seed=1) {setSeed(seed);}
+  ~RandGen() {}
+
+  void     setSeed(uint64_t);
+  uint64_t next();
+  double   uniform();
+  double   uniform(double lo, double hi) {return(lo + (hi-lo)*uniform());}
+
+ protected:
+  uint64_t m_s[4];
+};
+
+#endif
@@ -0,0 +1,463 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: VisGraph.cpp                                         */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <queue>
+#include <algorithm>
+#include "VisGraph.h"
+#include "GeomUtils.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+VisGraph::VisGraph()
+{
+  m_margin = 0.1;
+  m_edge_count = 0;
+  m_obs_grid = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void VisGraph::clear()
+{
+  m_polys.clear();
+  m_obs_grid = 0;
+  m_vx.clear();
+  m_vy.clear();
+  m_ox.clear();
+  m_oy.clear();
+  m_ax.clear();
+  m_ay.clear();
+  m_bx.clear();
+  m_by.clear();
+  m_edges.clear();
+  m_edge_count = 0;
+  clearBarriers();
+}
+
+//---------------------------------------------------------------
+// Procedure: addBarrier()
+
+void VisGraph::addBarrier(double x1, double y1, double x2, double y2)
+{
+  m_bar_x1.push_back(x1);
+  m_bar_y1.push_back(y1);
+  m_bar_x2.push_back(x2);
+  m_bar_y2.push_back(y2);
+}
+
+//---------------------------------------------------------------
+// Procedure: clearBarriers()
+
+void VisGraph::clearBarriers()
+{
+  m_bar_x1.clear();
+  m_bar_y1.clear();
+  m_bar_x2.clear();
+  m_bar_y2.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: build()
+//   Purpose: Build the obstacle part of the graph. Nodes are the
+//            pushed-out polygon vertices not inside any other
+//            obstacle. Edges join each pair of mutually visible
+//            nodes where the edge is tangent at both ends.
+//      Note: The grid must index the given polys by position,
+//            and stay unchanged until the next build or clear.
+
+void VisGraph::build(const vector<XYPolygon>& polys,
+		     const ObstacleGrid& obs_grid)
+{
+  clear();
+  m_polys = polys;
+  m_obs_grid = &obs_grid;
+
+  for(unsigned int i=0; i<m_polys.size(); i++)
+    addNodes(m_polys[i]);
+
+  m_edges.resize(m_vx.size());
+  for(unsigned int i=0; i<m_vx.size(); i++) {
+    for(unsigned int j=i+1; j<m_vx.size(); j++) {
+      if(!tangentAt(i, m_vx[j], m_vy[j]) || !tangentAt(j, m_vx[i], m_vy[i]))
+	continue;
+      if(freeSeg(m_vx[i], m_vy[i], m_vx[j], m_vy[j])) {
+	m_edges[i].push_back(j);
+	m_edges[j].push_back(i);
+	m_edge_count++;
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: addNodes()
+//      Note: For a convex polygon, the sum of the unit vectors
+//            from each neighbor to a vertex points outward along
+//            the bisector of the vertex angle.
+//      Note: Where pieces of one obstacle share a vertex, the
+//            bisector of one piece may point into the other. The
+//            outward normal of either edge at the vertex is then
+//            tried, so a convex corner of the whole obstacle still
+//            gets its node.
+
+void VisGraph::addNodes(const XYPolygon& poly)
+{
+  unsigned int vsize = poly.size();
+  if(vsize < 3)
+    return;
+
+  for(unsigned int i=0; i<vsize; i++) {
+    double vx = poly.get_vx(i);
+    double vy = poly.get_vy(i);
+    double ax = poly.get_vx((i+vsize-1) % vsize);
+    double ay = poly.get_vy((i+vsize-1) % vsize);
+    double bx = poly.get_vx((i+1) % vsize);
+    double by = poly.get_vy((i+1) % vsize);
+
+    double la = hypot(vx-ax, vy-ay);
+    double lb = hypot(vx-bx, vy-by);
+    if((la <= 0) || (lb <= 0))
+      continue;
+
+    double ux = (vx-ax)/la + (vx-bx)/lb;
+    double uy = (vy-ay)/la + (vy-by)/lb;
+    double lu = hypot(ux, uy);
+    if(lu <= 0)
+      continue;
+
+    double nx = vx + (m_margin * ux / lu);
+    double ny = vy + (m_margin * uy / lu);
+
+    bool inside = insideAny(nx, ny);
+    for(unsigned int k=0; (k<2) && inside; k++) {
+      // Normal of the edge to one neighbor, away from the other
+      double ex = (k==0) ? (vx-ax)/la : (vx-bx)/lb;
+      double ey = (k==0) ? (vy-ay)/la : (vy-by)/lb;
+      double ox = (k==0) ? (bx-vx) : (ax-vx);
+      double oy = (k==0) ? (by-vy) : (ay-vy);
+      double mx = -ey;
+      double my = ex;
+      if(((mx*ox) + (my*oy)) > 0) {
+	mx = -mx;
+	my = -my;
+      }
+      nx = vx + (m_margin * mx);
+      ny = vy + (m_margin * my);
+      inside = insideAny(nx, ny);
+    }
+    if(inside)
+      continue;
+
+    m_vx.push_back(nx);
+    m_vy.push_back(ny);
+    m_ox.push_back(vx);
+    m_oy.push_back(vy);
+    m_ax.push_back(ax);
+    m_ay.push_back(ay);
+    m_bx.push_back(bx);
+    m_by.push_back(by);
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: tangentAt()
+//   Purpose: Determine if the line from node ix toward px,py is
+//            tangent to the node's polygon, i.e., both polygon
+//            neighbors of the vertex lie on the same side of it.
+//      Note: A line along a polygon edge, e.g., to the next node
+//            on the polygon, is taken as tangent. Its end nodes are
+//            pushed out along different bisectors, so the line may
+//            miss the edge's far vertex by up to twice the margin,
+//            on either side.
+
+bool VisGraph::tangentAt(unsigned int ix, double px, double py) const
+{
+  double dx = px - m_vx[ix];
+  double dy = py - m_vy[ix];
+
+  double cross_a = dx*(m_ay[ix]-m_oy[ix]) - dy*(m_ax[ix]-m_ox[ix]);
+  double cross_b = dx*(m_by[ix]-m_oy[ix]) - dy*(m_bx[ix]-m_ox[ix]);
+
+  double len_d = hypot(dx, dy);
+  if((fabs(cross_a) <= 2 * m_margin * len_d) ||
+     (fabs(cross_b) <= 2 * m_margin * len_d))
+    return(true);
+
+  return((cross_a * cross_b) >= 0);
+}
+
+//---------------------------------------------------------------
+// Procedure: insideAny()
+
+bool VisGraph::insideAny(double px, double py) const
+{
+  if(!m_obs_grid)
+    return(false);
+
+  vector<unsigned int> cands;
+  m_obs_grid->ptCandidates(px, py, cands);
+  for(unsigned int i=0; i<cands.size(); i++) {
+    if(m_polys[cands[i]].contains(px, py))
+      return(true);
+  }
+  return(false);
+}
+
+//---------------------------------------------------------------
+// Procedure: freeSeg()
+//      Note: The candidate list is local, not a member, since the
+//            query calls are const and may run in several threads.
+
+bool VisGraph::freeSeg(double x1, double y1, double x2, double y2) const
+{
+  if(!m_obs_grid)
+    return(true);
+
+  vector<unsigned int> cands;
+  m_obs_grid->segCandidates(x1, y1, x2, y2, cands);
+  for(unsigned int i=0; i<cands.size(); i++) {
+    if(m_polys[cands[i]].seg_intercepts(x1, y1, x2, y2))
+      return(false);
+  }
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: crossesBarrier()
+
+bool VisGraph::crossesBarrier(double x1, double y1,
+			      double x2, double y2) const
+{
+  for(unsigned int i=0; i<m_bar_x1.size(); i++) {
+    if(segmentsCross(x1, y1, x2, y2, m_bar_x1[i], m_bar_y1[i],
+		     m_bar_x2[i], m_bar_y2[i]))
+      return(true);
+  }
+  return(false);
+}
+
+//---------------------------------------------------------------
+// Procedure: shortestPath()
+//   Purpose: Find the shortest obstacle-free path from the source
+//            to the destination with A*. The source and dest are
+//            nodes N and N+1, connected only for this query.
+//   Returns: Path length, or -1 if no path exists. On success the
+//            path is returned in the given seglist.
+
+double VisGraph::shortestPath(double sx, double sy, double dx, double dy,
+			      XYSegList& path) const
+{
+  path.clear();
+
+  unsigned int src = m_vx.size();
+  unsigned int dst = src + 1;
+
+  // Part 1: The direct leg, if free, is the answer
+  if(freeSeg(sx, sy, dx, dy) && !crossesBarrier(sx, sy, dx, dy)) {
+    path.add_vertex(sx, sy);
+    path.add_vertex(dx, dy);
+    return(hypot(dx-sx, dy-sy));
+  }
+
+  // Part 2: Connect the source and dest to the obstacle nodes
+  vector<unsigned int> src_edges;
+  vector<bool> dst_vis(src, false);
+  for(unsigned int i=0; i<src; i++) {
+    if(tangentAt(i, sx, sy) && freeSeg(sx, sy, m_vx[i], m_vy[i]))
+      src_edges.push_back(i);
+    if(tangentAt(i, dx, dy) && freeSeg(m_vx[i], m_vy[i], dx, dy))
+      dst_vis[i] = true;
+  }
+
+  // Part 3: A* over the combined graph
+  vector<double> gcost(src+2, -1);
+  vector<unsigned int> parent(src+2, src);
+  vector<bool> closed(src+2, false);
+
+  typedef pair<double, unsigned int> QEntry;
+  priority_queue<QEntry, vector<QEntry>, greater<QEntry> > open;
+
+  gcost[src] = 0;
+  open.push(QEntry(hypot(dx-sx, dy-sy), src));
+
+  while(!open.empty()) {
+    unsigned int ix = open.top().second;
+    open.pop();
+    if(closed[ix])
+      continue;
+    closed[ix] = true;
+    if(ix == dst)
+      break;
+
+    double ix_x = (ix == src) ? sx : m_vx[ix];
+    double ix_y = (ix == src) ? sy : m_vy[ix];
+
+    const vector<unsigned int>& nbrs = (ix == src) ? src_edges : m_edges[ix];
+    unsigned int nsize = nbrs.size();
+    if((ix != src) && dst_vis[ix])
+      nsize++;
+
+    for(unsigned int k=0; k<nsize; k++) {
+      unsigned int jx = (k < nbrs.size()) ? nbrs[k] : dst;
+      if(closed[jx])
+	continue;
+      double jx_x = (jx == dst) ? dx : m_vx[jx];
+      double jx_y = (jx == dst) ? dy : m_vy[jx];
+      if(crossesBarrier(ix_x, ix_y, jx_x, jx_y))
+	continue;
+
+      double g = gcost[ix] + hypot(jx_x-ix_x, jx_y-ix_y);
+      if((gcost[jx] >= 0) && (g >= gcost[jx]))
+	continue;
+      gcost[jx] = g;
+      parent[jx] = ix;
+      open.push(QEntry(g + hypot(dx-jx_x, dy-jx_y), jx));
+    }
+  }
+
+  if(!closed[dst])
+    return(-1);
+
+  // Part 4: Walk back from the dest to build the path
+  vector<unsigned int> rev;
+  for(unsigned int ix=dst; ix!=src; ix=parent[ix])
+    rev.push_back(ix);
+
+  path.add_vertex(sx, sy);
+  for(unsigned int k=rev.size(); k>0; k--) {
+    unsigned int ix = rev[k-1];
+    if(ix == dst)
+      path.add_vertex(dx, dy);
+    else
+      path.add_vertex(m_vx[ix], m_vy[ix]);
+  }
+
+  return(gcost[dst]);
+}
+
+//---------------------------------------------------------------
+// Procedure: shortestTree()
+//   Purpose: Grow the shortest path tree from the source over all
+//            nodes with Dijkstra. The source is node N. On return
+//            gcost holds the path length to each node, or -1 if
+//            unreachable, and parent the prior node on its path.
+
+void VisGraph::shortestTree(double sx, double sy, vector<double>& gcost,
+			    vector<unsigned int>& parent) const
+{
+  unsigned int src = m_vx.size();
+
+  gcost.assign(src+1, -1);
+  parent.assign(src+1, src);
+  vector<bool> closed(src+1, false);
+
+  vector<unsigned int> src_edges;
+  for(unsigned int i=0; i<src; i++) {
+    if(tangentAt(i, sx, sy) && freeSeg(sx, sy, m_vx[i], m_vy[i]))
+      src_edges.push_back(i);
+  }
+
+  typedef pair<double, unsigned int> QEntry;
+  priority_queue<QEntry, vector<QEntry>, greater<QEntry> > open;
+
+  gcost[src] = 0;
+  open.push(QEntry(0, src));
+
+  while(!open.empty()) {
+    unsigned int ix = open.top().second;
+    open.pop();
+    if(closed[ix])
+      continue;
+    closed[ix] = true;
+
+    double ix_x = (ix == src) ? sx : m_vx[ix];
+    double ix_y = (ix == src) ? sy : m_vy[ix];
+
+    const vector<unsigned int>& nbrs = (ix == src) ? src_edges : m_edges[ix];
+    for(unsigned int k=0; k<nbrs.size(); k++) {
+      unsigned int jx = nbrs[k];
+      if(closed[jx])
+	continue;
+      if(crossesBarrier(ix_x, ix_y, m_vx[jx], m_vy[jx]))
+	continue;
+
+      double g = gcost[ix] + hypot(m_vx[jx]-ix_x, m_vy[jx]-ix_y);
+      if((gcost[jx] >= 0) && (g >= gcost[jx]))
+	continue;
+      gcost[jx] = g;
+      parent[jx] = ix;
+      open.push(QEntry(g, jx));
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: pathFromTree()
+//   Purpose: Join a destination to a shortest path tree from the
+//            same source, through whichever visible tree node
+//            gives the shortest total.
+//   Returns: Path length, or -1 if no path exists. On success the
+//            path is returned in the given seglist.
+
+double VisGraph::pathFromTree(double sx, double sy, double dx, double dy,
+			      const vector<double>& gcost,
+			      const vector<unsigned int>& parent,
+			      XYSegList& path) const
+{
+  path.clear();
+
+  unsigned int src = m_vx.size();
+  if((gcost.size() != src+1) || (parent.size() != src+1))
+    return(-1);
+
+  if(freeSeg(sx, sy, dx, dy) && !crossesBarrier(sx, sy, dx, dy)) {
+    path.add_vertex(sx, sy);
+    path.add_vertex(dx, dy);
+    return(hypot(dx-sx, dy-sy));
+  }
+
+  // Cheap tests first, so the segment test is made only on nodes
+  // that would improve on the best so far
+  double best_dist = -1;
+  unsigned int best_ix = src;
+  for(unsigned int i=0; i<src; i++) {
+    if(gcost[i] < 0)
+      continue;
+    double dist = gcost[i] + hypot(dx-m_vx[i], dy-m_vy[i]);
+    if((best_dist >= 0) && (dist >= best_dist))
+      continue;
+    if(!tangentAt(i, dx, dy))
+      continue;
+    if(!freeSeg(m_vx[i], m_vy[i], dx, dy) ||
+       crossesBarrier(m_vx[i], m_vy[i], dx, dy))
+      continue;
+    best_dist = dist;
+    best_ix = i;
+  }
+  if(best_dist < 0)
+    return(-1);
+
+  vector<unsigned int> rev;
+  for(unsigned int ix=best_ix; ix!=src; ix=parent[ix])
+    rev.push_back(ix);
+
+  path.add_vertex(sx, sy);
+  for(unsigned int k=rev.size(); k>0; k--)
+    path.add_vertex(m_vx[rev[k-1]], m_vy[rev[k-1]]);
+  path.add_vertex(dx, dy);
+
+  return(best_dist);
+}
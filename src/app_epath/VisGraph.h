@@ -0,0 +1,96 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: VisGraph.h                                           */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef VIS_GRAPH_HEADER
+#define VIS_GRAPH_HEADER
+
+#include <vector>
+#include "XYSegList.h"
+#include "XYPolygon.h"
+#include "ObstacleGrid.h"
+
+//---------------------------------------------------------------
+// Visibility graph over the vertices of a set of convex polygon
+// obstacles. Each vertex is pushed outward by a small margin so
+// that paths may pass a vertex without touching it. Only tangent
+// edges are kept, i.e., edges that do not turn into the obstacle
+// at either end, since no shortest path uses any other. The
+// obstacle graph is built once, and each query connects the
+// source and destination to it and runs A* with the Euclidean
+// heuristic. Optional barrier segments, e.g., to force a side of
+// passage, are checked on the fly during the search. For many
+// destinations from one source, a shortest path tree is grown
+// once with Dijkstra and each destination is then joined to it.
+// Collision tests go through the caller's obstacle grid, which
+// must index the same polygons and outlive the built graph.
+
+class VisGraph {
+ public:
+  VisGraph();
+  ~VisGraph() {}
+
+  void   setMargin(double v) {if(v > 0) m_margin = v;}
+  void   build(const std::vector<XYPolygon>&, const ObstacleGrid&);
+  void   clear();
+
+  void   addBarrier(double x1, double y1, double x2, double y2);
+  void   clearBarriers();
+
+  double shortestPath(double sx, double sy, double dx, double dy,
+		      XYSegList& path) const;
+
+  void   shortestTree(double sx, double sy,
+		      std::vector<double>& gcost,
+		      std::vector<unsigned int>& parent) const;
+  double pathFromTree(double sx, double sy, double dx, double dy,
+		      const std::vector<double>& gcost,
+		      const std::vector<unsigned int>& parent,
+		      XYSegList& path) const;
+
+  unsigned int size() const      {return(m_vx.size());}
+  unsigned int edgeCount() const {return(m_edge_count);}
+
+ protected:
+  void   addNodes(const XYPolygon&);
+  bool   tangentAt(unsigned int ix, double px, double py) const;
+  bool   insideAny(double px, double py) const;
+  bool   freeSeg(double x1, double y1, double x2, double y2) const;
+  bool   crossesBarrier(double x1, double y1,
+			double x2, double y2) const;
+
+ protected: // State vars
+  std::vector<XYPolygon> m_polys;
+  const ObstacleGrid*    m_obs_grid;
+
+  std::vector<double> m_vx;
+  std::vector<double> m_vy;
+
+  // Original vertex and its two polygon neighbors, per node
+  std::vector<double> m_ox;
+  std::vector<double> m_oy;
+  std::vector<double> m_ax;
+  std::vector<double> m_ay;
+  std::vector<double> m_bx;
+  std::vector<double> m_by;
+
+  std::vector<std::vector<unsigned int> > m_edges;
+  unsigned int m_edge_count;
+
+  std::vector<double> m_bar_x1;
+  std::vector<double> m_bar_y1;
+  std::vector<double> m_bar_x2;
+  std::vector<double> m_bar_y2;
+
+ protected: // Config vars
+  double m_margin;
+};
+
+#endif
@@ -52,6 +52,21 @@ int main(int argc, char *argv[])
   // Look for a request for usage information
   if(scanArgs(argc, argv, "-h", "--help", "-help")) {
     cout << "Usage: polyview [filename] [filename]..." << endl;
+    cout << "  --mode=<random|vgraph|rrt>  Path solve mode (random)" << endl;
+    cout << "  --threads=<N>            Random search threads, 0=all (1)" << endl;
+    cout << "  --order=<depth|best|beam>  Random search order (depth)" << endl;
+    cout << "  --beam=<N>               Beam width in beam order (10)" << endl;
+    cout << "  --seed=<N>               Random search seed (random)" << endl;
+    cout << "  --budget=<ms>            Solve time budget, 0=none (0)" << endl;
+    cout << "  --warm                   Repair last path on src/dest moves" << endl;
+    cout << "  --clearance=<m>          Distance kept from obstacles (0)" << endl;
+    cout << "  --arc_tol=<m>            Max standoff of inflated corners (0.5)" << endl;
+    cout << "  --turn_radius=<m>        Smooth path to turn radius, 0=off (0)" << endl;
+    cout << "  --merge_gap=<m>          Merge obstacles closer than this (0)" << endl;
+    cout << "  --merge                  Merge obstacles read from files" << endl;
+    cout << "  --merge_hulls            Merge gap-linked groups to hulls" << endl;
+    cout << "  --src_hdg=<deg>          Source heading for smoothing (0)" << endl;
+    cout << "  --deads=<counts|sample|edges>  Dead path record (sample)" << endl;
     return(0);
   }
 
@@ -71,6 +86,8 @@ int main(int argc, char *argv[])
   vector<string>    all_poly_strings;
   vector<string>    all_segl_strings;
   vector<string>    all_point_strings;
+  vector<string>    all_gpoly_strings;
+  bool              merge_polys = false;
 
   for(i=1; i<argc; i++) {
     string argi  = argv[i];
@@ -79,6 +96,48 @@ int main(int argc, char *argv[])
       tif_file = argi;
     else if(argi == "-noimg")
       tif_file = "";
+    else if(strBegins(argi, "--mode=")) {
+      if(!gui->pviewer->setParam("solve_mode", argi.substr(7))) {
+	cout << "Unknown solve mode: " << argi.substr(7) << endl;
+	return(1);
+      }
+    }
+    else if(strBegins(argi, "--order=")) {
+      if(!gui->pviewer->setParam("search_order", argi.substr(8))) {
+	cout << "Unknown search order: " << argi.substr(8) << endl;
+	return(1);
+      }
+    }
+    else if(strBegins(argi, "--beam="))
+      gui->pviewer->setParam("beam_width", argi.substr(7));
+    else if(strBegins(argi, "--threads="))
+      gui->pviewer->setParam("threads", argi.substr(10));
+    else if(strBegins(argi, "--seed="))
+      gui->pviewer->setParam("seed", argi.substr(7));
+    else if(argi == "--warm")
+      gui->pviewer->setParam("warm_start", "true");
+    else if(strBegins(argi, "--clearance="))
+      gui->pviewer->setParam("clearance", argi.substr(12));
+    else if(strBegins(argi, "--arc_tol="))
+      gui->pviewer->setParam("arc_tol", argi.substr(10));
+    else if(strBegins(argi, "--merge_gap="))
+      gui->pviewer->setParam("merge_gap", argi.substr(12));
+    else if(argi == "--merge")
+      merge_polys = true;
+    else if(argi == "--merge_hulls")
+      gui->pviewer->setParam("merge_hulls", "true");
+    else if(strBegins(argi, "--turn_radius="))
+      gui->pviewer->setParam("turn_radius", argi.substr(14));
+    else if(strBegins(argi, "--src_hdg="))
+      gui->pviewer->setParam("src_hdg", argi.substr(10));
+    else if(strBegins(argi, "--budget="))
+      gui->pviewer->setParam("solve_budget", argi.substr(9));
+    else if(strBegins(argi, "--deads=")) {
+      if(!gui->pviewer->setParam("dead_mode", argi.substr(8))) {
+	cout << "Unknown dead path mode: " << argi.substr(8) << endl;
+	return(1);
+      }
+    }
     else {
       vector<string> svector;
       svector = readEntriesFromFile(argi, "poly:polygon");
@@ -92,6 +151,10 @@ int main(int argc, char *argv[])
       svector = readEntriesFromFile(argi, "point");
       for(j=0; j<svector.size(); j++)
 	all_point_strings.push_back(svector[j]);
+
+      svector = readEntriesFromFile(argi, "genpoly:obstacle");
+      for(j=0; j<svector.size(); j++)
+	all_gpoly_strings.push_back(svector[j]);
     }
   }
  
@@ -108,7 +171,15 @@ int main(int argc, char *argv[])
   cout << "# of file seglists: " << all_segl_strings.size() << endl;
   for(j=0; j<all_segl_strings.size(); j++)
     gui->pviewer->setParam("view_seglist", all_segl_strings[j]);
+
+  cout << "# of file genpoly obstacles: " << all_gpoly_strings.size() << endl;
+  for(j=0; j<all_gpoly_strings.size(); j++)
+    gui->pviewer->setParam("genpoly", all_gpoly_strings[j]);
+
+  if(merge_polys)
+    gui->pviewer->mergePolys();
   
+  gui->updateMenus();
   gui->updateXY();
 
   return Fl::run();
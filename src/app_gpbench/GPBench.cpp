@@ -0,0 +1,345 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: GPBench.cpp                                          */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <iostream>
+#include <cmath>
+#include "GPBench.h"
+#include "BorderIndex.h"
+#include "ExitDistTable.h"
+#include "DistField.h"
+#include "CoverIndex.h"
+#include "CoverEngine.h"
+#include "MBTimer.h"
+#include "MBUtils.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+GPBench::GPBench()
+{
+  m_border_size = 2000;
+  m_headings    = 360;
+  m_trials      = 50;
+  m_cell_size   = 2;
+  m_mem_cap     = 64;
+}
+
+//---------------------------------------------------------------
+// Procedure: makeBorder()
+//   Purpose: Build a star-shaped, non-convex test border with the
+//            configured number of vertices, centered on 0,0.
+
+XYSegList GPBench::makeBorder() const
+{
+  XYSegList segl;
+  for(unsigned int i=0; i<m_border_size; i++) {
+    double ang = (2 * M_PI * i) / m_border_size;
+    double rad = 100 + 30*sin(7*ang) + 5*sin(53*ang);
+    segl.add_vertex(rad * cos(ang), rad * sin(ang));
+  }
+  return(segl);
+}
+
+//---------------------------------------------------------------
+// Procedure: benchExitDist()
+//   Purpose: Compare the grid-indexed ray-to-exit query against
+//            the linear walk over every border edge. Each trial
+//            picks an interior point and sweeps all headings.
+
+void GPBench::benchExitDist()
+{
+  XYSegList border = makeBorder();
+
+  MBTimer build_timer;
+  build_timer.start();
+  BorderIndex index;
+  index.setBorder(border);
+  build_timer.stop();
+
+  // Part 1: Pick the interior trial points along a spiral
+  vector<double> vx, vy;
+  for(unsigned int i=0; i<m_trials; i++) {
+    double ang = i * 2.39996;
+    double rad = 60.0 * sqrt((double)(i+1) / (double)(m_trials));
+    vx.push_back(rad * cos(ang));
+    vy.push_back(rad * sin(ang));
+  }
+
+  // Part 2: Time the linear walk
+  double sum_lin = 0;
+  MBTimer lin_timer;
+  lin_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++) {
+    for(unsigned int h=0; h<m_headings; h++) {
+      double hdg = (360.0 * h) / m_headings;
+      sum_lin += index.distRayToExitLinear(vx[i], vy[i], hdg);
+    }
+  }
+  lin_timer.stop();
+
+  // Part 3: Time the indexed query and check agreement
+  double sum_idx = 0;
+  MBTimer idx_timer;
+  idx_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++) {
+    for(unsigned int h=0; h<m_headings; h++) {
+      double hdg = (360.0 * h) / m_headings;
+      sum_idx += index.distRayToExit(vx[i], vy[i], hdg);
+    }
+  }
+  idx_timer.stop();
+
+  double max_diff = 0;
+  for(unsigned int i=0; i<vx.size(); i++) {
+    for(unsigned int h=0; h<m_headings; h++) {
+      double hdg = (360.0 * h) / m_headings;
+      double d1 = index.distRayToExitLinear(vx[i], vy[i], hdg);
+      double d2 = index.distRayToExit(vx[i], vy[i], hdg);
+      if(fabs(d1-d2) > max_diff)
+	max_diff = fabs(d1-d2);
+    }
+  }
+
+  // Part 4: Report
+  double queries = (double)(vx.size() * m_headings);
+  double lin_ns  = (lin_timer.get_float_wall_time() * 1e9) / queries;
+  double idx_ns  = (idx_timer.get_float_wall_time() * 1e9) / queries;
+
+  cout << "Ray-to-exit benchmark" << endl;
+  cout << "  border verts:  " << index.size() << endl;
+  cout << "  grid cells:    " << index.cellCount() << endl;
+  cout << "  build time:    " <<
+    doubleToString(build_timer.get_float_wall_time()*1000, 3) << " ms" << endl;
+  cout << "  queries:       " << vx.size() << " pts x " << m_headings <<
+    " hdgs" << endl;
+  cout << "  linear walk:   " << doubleToString(lin_ns, 1) << " ns/query" << endl;
+  cout << "  grid index:    " << doubleToString(idx_ns, 1) << " ns/query" << endl;
+  if(idx_ns > 0)
+    cout << "  speedup:       " << doubleToString(lin_ns/idx_ns, 1) << "x" << endl;
+  cout << "  max diff:      " << max_diff << endl;
+  cout << "  checksums:     " << sum_lin << " / " << sum_idx << endl;
+}
+
+//---------------------------------------------------------------
+// Procedure: benchExitTable()
+//   Purpose: Build the position x heading exit distance table and
+//            compare lookups against the exact indexed query at
+//            the same set of interior poses.
+
+void GPBench::benchExitTable()
+{
+  XYSegList border = makeBorder();
+
+  ExitDistTable table;
+  table.setBorder(border);
+  table.setCellSize(m_cell_size);
+  table.setMemoryCap(m_mem_cap);
+  table.build();
+
+  // Part 1: Pick the interior trial poses along a spiral, with an
+  // irrational heading step so poses fall between table nodes.
+  vector<double> vx, vy, vh;
+  unsigned int total = m_trials * m_headings;
+  for(unsigned int i=0; i<total; i++) {
+    double ang = i * 2.39996;
+    double rad = 60.0 * sqrt((double)(i+1) / (double)(total));
+    vx.push_back(rad * cos(ang));
+    vy.push_back(rad * sin(ang));
+    vh.push_back(fmod(i * 137.508, 360.0));
+  }
+
+  // Part 2: Time the exact and table queries
+  double sum_exact = 0;
+  MBTimer exact_timer;
+  exact_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++)
+    sum_exact += table.distRayToExitExact(vx[i], vy[i], vh[i]);
+  exact_timer.stop();
+
+  double sum_table = 0;
+  MBTimer table_timer;
+  table_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++)
+    sum_table += table.distRayToExit(vx[i], vy[i], vh[i]);
+  table_timer.stop();
+
+  // Part 3: Report
+  double queries  = (double)(vx.size());
+  double exact_ns = (exact_timer.get_float_wall_time() * 1e9) / queries;
+  double table_ns = (table_timer.get_float_wall_time() * 1e9) / queries;
+
+  cout << "Exit distance table benchmark" << endl;
+  cout << "  border verts:  " << m_border_size << endl;
+  cout << "  cell size:     " << doubleToString(table.getCellSize(), 3) <<
+    " m, hdg step " << doubleToString(table.getHdgStep(), 2) << " deg" << endl;
+  cout << "  memory:        " <<
+    doubleToString(table.getMemoryBytes() / (1024.0*1024.0), 2) << " MB" << endl;
+  cout << "  build time:    " <<
+    doubleToString(table.getBuildTime()*1000, 1) << " ms" << endl;
+  cout << "  error max:     " << doubleToString(table.getErrorMax(), 3) <<
+    " m, avg " << doubleToString(table.getErrorAvg(), 3) << " m" << endl;
+  cout << "  fallback:      " << doubleToString(table.getFallbackPct(), 1) <<
+    " pct of samples" << endl;
+  cout << "  exact index:   " << doubleToString(exact_ns, 1) << " ns/query" << endl;
+  cout << "  table lookup:  " << doubleToString(table_ns, 1) << " ns/query" << endl;
+  cout << "  checksums:     " << sum_exact << " / " << sum_table << endl;
+}
+
+//---------------------------------------------------------------
+// Procedure: benchDistField()
+//   Purpose: Build the signed distance field and compare its
+//            queries against exact distance to the border, at
+//            points spread over the field, inside and out.
+
+void GPBench::benchDistField()
+{
+  XYSegList border = makeBorder();
+
+  MBTimer build_timer;
+  build_timer.start();
+  DistField field;
+  field.setCellSize(m_cell_size);
+  field.setBorder(border);
+  build_timer.stop();
+
+  // Part 1: Pick trial points on a spiral reaching past the border
+  vector<double> vx, vy;
+  unsigned int total = m_trials * m_headings;
+  for(unsigned int i=0; i<total; i++) {
+    double ang = i * 2.39996;
+    double rad = 150.0 * sqrt((double)(i+1) / (double)(total));
+    vx.push_back(rad * cos(ang));
+    vy.push_back(rad * sin(ang));
+  }
+
+  // Part 2: Time the exact and field queries
+  double sum_exact = 0;
+  MBTimer exact_timer;
+  exact_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++)
+    sum_exact += field.signedDistExact(vx[i], vy[i]);
+  exact_timer.stop();
+
+  double sum_field = 0;
+  MBTimer field_timer;
+  field_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++)
+    sum_field += field.signedDist(vx[i], vy[i]);
+  field_timer.stop();
+
+  double max_err = 0;
+  for(unsigned int i=0; i<vx.size(); i++) {
+    double err = fabs(field.signedDist(vx[i], vy[i]) -
+		      field.signedDistExact(vx[i], vy[i]));
+    if(err > max_err)
+      max_err = err;
+  }
+
+  // Part 3: Report
+  double queries  = (double)(vx.size());
+  double exact_ns = (exact_timer.get_float_wall_time() * 1e9) / queries;
+  double field_ns = (field_timer.get_float_wall_time() * 1e9) / queries;
+
+  cout << "Signed distance field benchmark" << endl;
+  cout << "  border verts:  " << m_border_size << endl;
+  cout << "  cell size:     " << doubleToString(field.getCellSize(), 3) <<
+    " m" << endl;
+  cout << "  memory:        " <<
+    doubleToString(field.getMemoryBytes() / (1024.0*1024.0), 2) << " MB" << endl;
+  cout << "  build time:    " <<
+    doubleToString(build_timer.get_float_wall_time()*1000, 1) << " ms" << endl;
+  cout << "  error max:     " << doubleToString(max_err, 3) << " m, bound " <<
+    doubleToString(field.getErrorBound(), 3) << " m" << endl;
+  cout << "  exact index:   " << doubleToString(exact_ns, 1) << " ns/query" << endl;
+  cout << "  field lookup:  " << doubleToString(field_ns, 1) << " ns/query" << endl;
+  cout << "  checksums:     " << sum_exact << " / " << sum_field << endl;
+}
+
+//---------------------------------------------------------------
+// Procedure: benchCoverDist()
+//   Purpose: Compare the pruned nearest-first distance to the cover
+//            pieces against the walk over all pieces, for points
+//            and short segments spread inside and outside.
+//      Note: The cover solve grows quickly with border size, so the
+//            border is capped at 100 vertices here.
+
+void GPBench::benchCoverDist()
+{
+  unsigned int border_size = m_border_size;
+  if(m_border_size > 100)
+    m_border_size = 100;
+  XYSegList border = makeBorder();
+  m_border_size = border_size;
+
+  CoverEngine engine;
+  engine.setPoints(border);
+  XYGenPolygon gpoly = engine.getGenPoly();
+
+  CoverIndex index;
+  index.setGenPoly(gpoly);
+
+  // Part 1: Pick trial points on a spiral reaching past the border
+  vector<double> vx, vy;
+  unsigned int total = m_trials * m_headings;
+  for(unsigned int i=0; i<total; i++) {
+    double ang = i * 2.39996;
+    double rad = 150.0 * sqrt((double)(i+1) / (double)(total));
+    vx.push_back(rad * cos(ang));
+    vy.push_back(rad * sin(ang));
+  }
+
+  // Part 2: Time point and segment queries, linear then pruned
+  double sum_lin = 0;
+  MBTimer lin_timer;
+  lin_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++) {
+    sum_lin += index.distLinear(vx[i], vy[i]);
+    sum_lin += index.distLinear(vx[i], vy[i], vx[i]+5, vy[i]+5);
+  }
+  lin_timer.stop();
+
+  double sum_bnb = 0;
+  MBTimer bnb_timer;
+  bnb_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++) {
+    sum_bnb += index.dist_to_poly(vx[i], vy[i]);
+    sum_bnb += index.dist_to_poly(vx[i], vy[i], vx[i]+5, vy[i]+5);
+  }
+  bnb_timer.stop();
+
+  unsigned int hits = 0;
+  MBTimer within_timer;
+  within_timer.start();
+  for(unsigned int i=0; i<vx.size(); i++) {
+    if(index.withinDist(vx[i], vy[i], 10))
+      hits++;
+  }
+  within_timer.stop();
+
+  // Part 3: Report
+  double queries   = (double)(vx.size() * 2);
+  double lin_ns    = (lin_timer.get_float_wall_time() * 1e9) / queries;
+  double bnb_ns    = (bnb_timer.get_float_wall_time() * 1e9) / queries;
+  double within_ns = (within_timer.get_float_wall_time() * 1e9) / vx.size();
+
+  cout << "Cover distance benchmark" << endl;
+  cout << "  border verts:  " << border.size() << endl;
+  cout << "  cover pieces:  " << index.size() << endl;
+  cout << "  all pieces:    " << doubleToString(lin_ns, 1) << " ns/query" << endl;
+  cout << "  nearest-first: " << doubleToString(bnb_ns, 1) << " ns/query" << endl;
+  if(bnb_ns > 0)
+    cout << "  speedup:       " << doubleToString(lin_ns/bnb_ns, 1) << "x" << endl;
+  cout << "  withinDist:    " << doubleToString(within_ns, 1) <<
+    " ns/query, " << hits << " of " << vx.size() << " within 10m" << endl;
+  cout << "  checksums:     " << sum_lin << " / " << sum_bnb << endl;
+}
@@ -0,0 +1,44 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: GPBench.h                                            */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef GP_BENCH_HEADER
+#define GP_BENCH_HEADER
+
+#include "XYSegList.h"
+
+class GPBench {
+ public:
+  GPBench();
+  ~GPBench() {}
+
+  void setBorderSize(unsigned int v) {m_border_size = v;}
+  void setHeadings(unsigned int v)    {m_headings = v;}
+  void setTrials(unsigned int v)      {m_trials = v;}
+  void setCellSize(double v)          {m_cell_size = v;}
+  void setMemoryCap(double v)         {m_mem_cap = v;}
+
+  void benchExitDist();
+  void benchExitTable();
+  void benchDistField();
+  void benchCoverDist();
+
+ protected:
+  XYSegList makeBorder() const;
+
+ protected: // Config vars
+  unsigned int m_border_size;
+  unsigned int m_headings;
+  unsigned int m_trials;
+  double       m_cell_size;
+  double       m_mem_cap;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: main.cpp                                             */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <iostream>
+#include <cstdlib>
+#include "GPBench.h"
+#include "MBUtils.h"
+
+using namespace std;
+
+void showHelpAndExit();
+
+//--------------------------------------------------------
+// Procedure: main
+
+int main(int argc, char *argv[])
+{
+  GPBench bench;
+
+  bool bench_exit  = false;
+  bool bench_table = false;
+  bool bench_sdf   = false;
+  bool bench_cover = false;
+
+  for(int i=1; i<argc; i++) {
+    string argi  = argv[i];
+
+    if((argi == "-h") || (argi == "--help"))
+      showHelpAndExit();
+    else if(argi == "--exit")
+      bench_exit = true;
+    else if(argi == "--table")
+      bench_table = true;
+    else if(argi == "--sdf")
+      bench_sdf = true;
+    else if(argi == "--cover")
+      bench_cover = true;
+    else if(strBegins(argi, "--verts="))
+      bench.setBorderSize(atoi(argi.substr(8).c_str()));
+    else if(strBegins(argi, "--hdgs="))
+      bench.setHeadings(atoi(argi.substr(7).c_str()));
+    else if(strBegins(argi, "--trials="))
+      bench.setTrials(atoi(argi.substr(9).c_str()));
+    else if(strBegins(argi, "--cell="))
+      bench.setCellSize(atof(argi.substr(7).c_str()));
+    else if(strBegins(argi, "--memcap="))
+      bench.setMemoryCap(atof(argi.substr(9).c_str()));
+    else {
+      cout << "Unhandled arg: " << argi << endl;
+      return(1);
+    }
+  }
+
+  // With no benchmark named, run them all
+  if(!bench_exit && !bench_table && !bench_sdf && !bench_cover) {
+    bench_exit  = true;
+    bench_table = true;
+    bench_sdf   = true;
+    bench_cover = true;
+  }
+
+  if(bench_exit)
+    bench.benchExitDist();
+  if(bench_table)
+    bench.benchExitTable();
+  if(bench_sdf)
+    bench.benchDistField();
+  if(bench_cover)
+    bench.benchCoverDist();
+
+  return(0);
+}
+
+
+//------------------------------------------------------------
+// Procedure: showHelpAndExit()
+
+void showHelpAndExit()
+{
+  cout << "Usage: " << endl;
+  cout << "  gpbench [OPTIONS]                                 " << endl;
+  cout << "                                                    " << endl;
+  cout << "Synopsis:                                           " << endl;
+  cout << "  Timing benchmarks for genpoly queries. With no    " << endl;
+  cout << "  benchmark named, all benchmarks are run.          " << endl;
+  cout << "                                                    " << endl;
+  cout << "Options:                                            " << endl;
+  cout << "  -h,--help            Displays this help message   " << endl;
+  cout << "  --exit               Ray-to-exit, grid vs linear  " << endl;
+  cout << "  --table              Exit table vs exact query    " << endl;
+  cout << "  --sdf                Distance field vs exact query" << endl;
+  cout << "  --cover              Cover distance, pruned vs all" << endl;
+  cout << "  --verts=<n>          Border vertices (2000)       " << endl;
+  cout << "  --hdgs=<n>           Headings per point (360)     " << endl;
+  cout << "  --trials=<n>         Interior points (50)         " << endl;
+  cout << "  --cell=<m>           Exit table cell size (2)     " << endl;
+  cout << "  --memcap=<mb>        Exit table memory cap (64)   " << endl;
+  exit(0);
+}
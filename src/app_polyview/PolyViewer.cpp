@@ -39,6 +39,7 @@ PolyViewer::PolyViewer(int x, int y, int w, int h, const char *l)
   m_draw_segl    = true;
   m_draw_hull    = false;
   m_draw_gpoly   = true;
+  m_gpoly_draw_ok = false;
   m_snap_val     = 2.0;
   m_solve_collap = true;
   m_solve_method = "shallow"; 
@@ -168,14 +169,10 @@ void PolyViewer::draw()
   }
 
   if(m_draw_gpoly) {
-    vector<XYPolygon> polys = m_gen_poly.getCoverPolys();
-    //cout << "total polys:" << polys.size() << endl;
-    for(unsigned int i=0; i<polys.size(); i++) {
-      XYPolygon poly = polys[i];
-      poly.set_color("edge", "gray80");
-      poly.set_color("fill", "gray50");
-      drawPolygon(poly);
-    }
+    if(!m_gpoly_draw_ok)
+      refreshDrawPolys();
+    for(unsigned int i=0; i<m_gpoly_draw.size(); i++)
+      drawPolygon(m_gpoly_draw[i]);
   }
 
   // ------------------------------------------------------
@@ -403,7 +400,9 @@ void PolyViewer::clear()
 {  
   m_segl.clear();
   m_hull_poly.clear();
-  m_gen_poly.clear();
+  m_gen_shape.clear();
+  m_gpoly_draw.clear();
+  m_border_index.clear();
   m_solve_time = 0;
 }
 
@@ -420,7 +419,7 @@ string PolyViewer::getBorderSpec()
 
 string PolyViewer::getGPolySpec()
 {  
-  return(m_gen_poly.get_spec());
+  return(m_gen_shape.getGenPoly().get_spec());
 }
 
 // ----------------------------------------------------------
@@ -430,7 +429,8 @@ void PolyViewer::shiftHorzPoints(double shift_val)
 {
   m_segl.shift_horz(shift_val);
   updateConvexHull();
-  updateGenPoly();
+  m_gen_shape.shiftHorz(shift_val);
+  updateMovedGenPoly();
 }
 
 // ----------------------------------------------------------
@@ -440,7 +440,8 @@ void PolyViewer::shiftVertPoints(double shift_val)
 {
   m_segl.shift_vert(shift_val);
   updateConvexHull();
-  updateGenPoly();
+  m_gen_shape.shiftVert(shift_val);
+  updateMovedGenPoly();
 }
 
 // ----------------------------------------------------------
@@ -448,12 +449,17 @@ void PolyViewer::shiftVertPoints(double shift_val)
 //   Purpose: Rotate the points around its center by the given
 //            number of degrees. Each point in the cluster is 
 //            rotated around the calculated center of the clsteru
+//      Note: The cover is rotated about the same center rather
+//            than solved again.
 
 void PolyViewer::rotatePoints(int rval)
 {
+  double cx = m_segl.get_center_x();
+  double cy = m_segl.get_center_y();
   m_segl.rotate(rval);
   updateConvexHull();
-  updateGenPoly();
+  m_gen_shape.rotate(rval, cx, cy);
+  updateMovedGenPoly();
 }
 
 // ----------------------------------------------------------
@@ -516,12 +522,11 @@ void PolyViewer::updateConvexHull()
 
 // ----------------------------------------------------------
 // Procedure: updateGenPoly()
+//      Note: The cover is solved even when it is not drawn, so
+//            it is current when drawing is turned back on.
 
 void PolyViewer::updateGenPoly()
 {
-  if(!m_draw_gpoly)
-    return;
-  
   CoverEngine engine;
   bool ok = engine.setPoints(m_segl);
   if(!ok)
@@ -533,13 +538,51 @@ void PolyViewer::updateGenPoly()
 
   MBTimer timer;
   timer.start();
-  m_gen_poly = engine.getGenPoly();
+  m_gen_shape.setGenPoly(engine.getGenPoly());
   timer.stop(); 
   m_solve_time = timer.get_float_wall_time();
 
+  m_border_index.setGenPoly(m_gen_shape.getBaseGenPoly());
+  m_gpoly_draw_ok = false;
+
   updateSeglr();
 }  
 
+// ----------------------------------------------------------
+// Procedure: updateMovedGenPoly()
+//   Purpose: After a shift or rotation of the existing cover,
+//            refresh what depends on its world position without
+//            solving the cover again. The border index stays in
+//            the frame of the solved cover.
+
+void PolyViewer::updateMovedGenPoly()
+{
+  m_gpoly_draw_ok = false;
+  updateSeglr();
+}
+
+// ----------------------------------------------------------
+// Procedure: refreshDrawPolys()
+//   Purpose: Keep colored copies of the cover pieces for drawing,
+//            made on the first frame after a change to the genpoly
+//            rather than on every frame. Moving the genpoly only
+//            marks them stale, so the moved cover is folded out
+//            once per drawn frame at most.
+
+void PolyViewer::refreshDrawPolys()
+{
+  m_gpoly_draw.clear();
+  m_gpoly_draw_ok = true;
+
+  const vector<XYPolygon>& polys = m_gen_shape.getCoverPolys();
+  for(unsigned int i=0; i<polys.size(); i++) {
+    XYPolygon poly = polys[i];
+    poly.set_color("edge", "gray80");
+    poly.set_color("fill", "gray50");
+    m_gpoly_draw.push_back(poly);
+  }
+}
+
 // ----------------------------------------------------------
 // Procedure: updateSeglr()
 
@@ -554,19 +597,29 @@ void PolyViewer::updateSeglr()
   double ry = m_seglr.getRayBaseY();
   double ray_angle = m_seglr.getRayAngle();
 
-  m_seglr_dist_to_exit = m_gen_poly.distSeglrToExitGP(m_seglr);
-  m_osh_dist_to_exit = m_gen_poly.distRayToExitGP(m_osx,m_osy,m_osh); 
+  // Exit queries are mapped into the frame of the solved cover
+  double bx, by;
+  m_gen_shape.toBase(m_osx, m_osy, bx, by);
+  double bh = m_gen_shape.toBaseHdg(m_osh);
+
+  XYSeglr base_seglr = m_gen_shape.toBase(m_seglr);
+  m_seglr_dist_to_exit = m_border_index.distSeglrToExit(base_seglr);
+  m_osh_dist_to_exit = m_border_index.distRayToExit(bx,by,bh); 
 
   XYSegList m_base = m_seglr.getBaseSegList();
 
   //cout << "base size:" << m_base.size() << endl;
 
   bool exited = false;
-  m_seg_dist_to_exit = m_gen_poly.distSeglToExitGP(m_base, exited); 
+  XYSegList base_segl = m_gen_shape.toBase(m_base);
+  m_seg_dist_to_exit = m_border_index.distSeglToExit(base_segl, exited); 
 
   m_ray_dist_to_exit = 0;
-  if(!exited)
-    m_ray_dist_to_exit = m_gen_poly.distRayToExitGP(rx,ry,ray_angle); 
+  if(!exited) {
+    m_gen_shape.toBase(rx, ry, bx, by);
+    bh = m_gen_shape.toBaseHdg(ray_angle);
+    m_ray_dist_to_exit = m_border_index.distRayToExit(bx,by,bh); 
+  }
 }
  
 // ----------------------------------------------------------
@@ -13,9 +13,12 @@
 #define POLY_VIEWER_HEADER
 
 #include <string>
+#include <vector>
 #include "MarineViewer.h"
 #include "XYSegList.h"
 #include "XYGenPolygon.h"
+#include "GenPolyShape.h"
+#include "BorderIndex.h"
 #include "PMGen_Dubins.h"
 
 class PolyViewer : public MarineViewer
@@ -51,7 +54,7 @@ public:
   void   reversePoints();
   double getSnap() const  {return(m_snap_val);}
 
-  unsigned int getPolyCount() const   {return(m_gen_poly.getPolyCount());}
+  unsigned int getPolyCount() const   {return(m_gen_shape.getPolyCount());}
   double       getSolveTime() const   {return(m_solve_time);}
   std::string  getSolveMethod() const {return(m_solve_method);}
   bool         getSolveCollap() const {return(m_solve_collap);}
@@ -64,6 +67,10 @@ public:
   void   updateConvexHull();
   void   updateGenPoly();
   void   updateSeglr();
+
+private:
+  void   updateMovedGenPoly();
+  void   refreshDrawPolys();
   
 private: // Config vars
   bool   m_draw_pts;
@@ -79,7 +86,10 @@ private:
   XYSegList m_segl;
   XYPolygon m_hull_poly;
 
-  XYGenPolygon m_gen_poly;
+  GenPolyShape m_gen_shape;
+  std::vector<XYPolygon> m_gpoly_draw;
+  bool                   m_gpoly_draw_ok;
+  BorderIndex  m_border_index;
 
   PMGen_Dubins m_pmgen;
   double  m_osx;
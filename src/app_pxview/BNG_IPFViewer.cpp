@@ -374,7 +374,7 @@ IvPFunction *BNG_IPFViewer::buildIPF_OpRegion()
   // Part 3: Update the InfoBuffer
   m_bhv->setInfoBuffer(m_info_buffer);
 
-  XYGenPolygon core_poly = m_xmodel->getGenPoly();
+  const XYGenPolygon& core_poly = m_xmodel->getGenPoly();
   string core_poly_str = core_poly.get_spec();
 
   
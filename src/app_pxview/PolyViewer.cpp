@@ -39,6 +39,7 @@ PolyViewer::PolyViewer(int x, int y, int w, int h, const char *l)
   m_draw_segl    = true;
   m_draw_hull    = false;
   m_draw_gpoly   = true;
+  m_gpoly_draw_ok = false;
   m_snap_val     = 2.0;
   m_solve_collap = true;
   m_solve_method = "shallow"; 
@@ -163,15 +164,10 @@ void PolyViewer::draw()
   }
 
   if(m_draw_gpoly) {
-    XYGenPolygon gen_poly = m_xmodel->getGenPoly();
-    vector<XYPolygon> polys = gen_poly.getCoverPolys();
-    //cout << "total polys:" << polys.size() << endl;
-    for(unsigned int i=0; i<polys.size(); i++) {
-      XYPolygon poly = polys[i];
-      poly.set_color("edge", "gray80");
-      poly.set_color("fill", "gray50");
-      drawPolygon(poly);
-    }
+    if(!m_gpoly_draw_ok)
+      refreshDrawPolys();
+    for(unsigned int i=0; i<m_gpoly_draw.size(); i++)
+      drawPolygon(m_gpoly_draw[i]);
   }
 
   // ------------------------------------------------------
@@ -433,8 +429,7 @@ string PolyViewer::getGPolySpec()
   if(!m_xmodel)
     return("");
 
-  XYGenPolygon gen_poly = m_xmodel->getGenPoly();
-  return(gen_poly.get_spec());
+  return(m_xmodel->getGenPoly().get_spec());
 }
 
 // ----------------------------------------------------------
@@ -443,7 +438,11 @@ string PolyViewer::getGPolySpec()
 void PolyViewer::shiftHorzPoints(double shift_val)
 {
   m_segl.shift_horz(shift_val);
-  updateGenPoly();
+  if(m_xmodel && m_draw_gpoly) {
+    m_xmodel->shiftGenPoly(shift_val, 0);
+    m_gpoly_draw_ok = false;
+    updateSeglr();
+  }
 }
 
 // ----------------------------------------------------------
@@ -452,7 +451,11 @@ void PolyViewer::shiftHorzPoints(double shift_val)
 void PolyViewer::shiftVertPoints(double shift_val)
 {
   m_segl.shift_vert(shift_val);
-  updateGenPoly();
+  if(m_xmodel && m_draw_gpoly) {
+    m_xmodel->shiftGenPoly(0, shift_val);
+    m_gpoly_draw_ok = false;
+    updateSeglr();
+  }
 }
 
 // ----------------------------------------------------------
@@ -461,11 +464,19 @@ void PolyViewer::shiftVertPoints(double shift_val)
 //            given number of degrees. Each point in the 
 //            cluster is rotated around the calculated center
 //            of the cluster.
+//      Note: The cover is rotated about the same center rather
+//            than solved again.
 
 void PolyViewer::rotatePoints(int rval)
 {
+  double cx = m_segl.get_center_x();
+  double cy = m_segl.get_center_y();
   m_segl.rotate(rval);
-  updateGenPoly();
+  if(m_xmodel && m_draw_gpoly) {
+    m_xmodel->rotateGenPoly(rval, cx, cy);
+    m_gpoly_draw_ok = false;
+    updateSeglr();
+  }
 }
 
 // ----------------------------------------------------------
@@ -500,8 +511,7 @@ unsigned int PolyViewer::getPolyCount() const
   if(!m_xmodel)
     return(0);
 
-  XYGenPolygon gen_poly = m_xmodel->getGenPoly();
-  return(gen_poly.getPolyCount());
+  return(m_xmodel->getCoverPolys().size());
 }
 
 // ----------------------------------------------------------
@@ -565,6 +575,7 @@ void PolyViewer::updateGenPoly()
   XYGenPolygon gen_poly = engine.getGenPoly();
   m_xmodel->setGenPoly(gen_poly);
   //m_gen_poly = engine.getGenPoly();
+  m_gpoly_draw_ok = false;
 
   timer.stop(); 
   m_solve_time = timer.get_float_wall_time();
@@ -572,6 +583,30 @@ void PolyViewer::updateGenPoly()
   updateSeglr();
 }  
 
+// ----------------------------------------------------------
+// Procedure: refreshDrawPolys()
+//   Purpose: Keep colored copies of the cover pieces for drawing,
+//            made on the first frame after a change to the genpoly
+//            rather than on every frame. Moving the genpoly only
+//            marks them stale, so the moved cover is folded out
+//            once per drawn frame at most.
+
+void PolyViewer::refreshDrawPolys()
+{
+  m_gpoly_draw.clear();
+  m_gpoly_draw_ok = true;
+  if(!m_xmodel)
+    return;
+
+  const vector<XYPolygon>& polys = m_xmodel->getCoverPolys();
+  for(unsigned int i=0; i<polys.size(); i++) {
+    XYPolygon poly = polys[i];
+    poly.set_color("edge", "gray80");
+    poly.set_color("fill", "gray50");
+    m_gpoly_draw.push_back(poly);
+  }
+}
+
 // ----------------------------------------------------------
 // Procedure: updateSeglr()
 
@@ -593,24 +628,18 @@ void PolyViewer::updateSeglr()
   double ry = seglr.getRayBaseY();
   double ray_angle = seglr.getRayAngle();
 
-  XYGenPolygon gen_poly = m_xmodel->getGenPoly();
-  
-  //m_seglr_dist_to_exit = m_gen_poly.distSeglrToExitGP(m_seglr);
-  //m_osh_dist_to_exit = m_gen_poly.distRayToExitGP(m_osx,m_osy,m_osh); 
-  m_seglr_dist_to_exit = gen_poly.distSeglrToExitGP(seglr);
-  m_osh_dist_to_exit = gen_poly.distRayToExitGP(osx,osy,osh); 
+  m_seglr_dist_to_exit = m_xmodel->distSeglrToExit(seglr);
+  m_osh_dist_to_exit = m_xmodel->distRayToExit(osx,osy,osh); 
 
   XYSegList m_base = seglr.getBaseSegList();
 
   //cout << "base size:" << m_base.size() << endl;
 
   bool exited = false;
-  //m_seg_dist_to_exit = m_gen_poly.distSeglToExitGP(m_base, exited); 
-  m_seg_dist_to_exit = gen_poly.distSeglToExitGP(m_base, exited); 
+  m_seg_dist_to_exit = m_xmodel->distSeglToExit(m_base, exited); 
 
   m_ray_dist_to_exit = 0;
   if(!exited)
-    //m_ray_dist_to_exit = m_gen_poly.distRayToExitGP(rx,ry,ray_angle); 
-    m_ray_dist_to_exit = gen_poly.distRayToExitGP(rx,ry,ray_angle); 
+    m_ray_dist_to_exit = m_xmodel->distRayToExit(rx,ry,ray_angle); 
 }
  
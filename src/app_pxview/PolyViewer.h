@@ -13,6 +13,7 @@
 #define POLY_VIEWER_HEADER
 
 #include <string>
+#include <vector>
 #include "MarineViewer.h"
 #include "XModel.h"
 #include "XYSegList.h"
@@ -65,6 +66,9 @@ public:
   XYPolygon getConvexHull();
   void      updateGenPoly();
   void      updateSeglr();
+
+private:
+  void      refreshDrawPolys();
   
 private: // Config vars
   bool   m_draw_pts;
@@ -80,6 +84,9 @@ private:
   XModel*  m_xmodel;
   XYSegList m_segl;
 
+  std::vector<XYPolygon> m_gpoly_draw;
+  bool                   m_gpoly_draw_ok;
+
   double  m_seglr_dist_to_exit;
   double  m_osh_dist_to_exit;
   double  m_seg_dist_to_exit;
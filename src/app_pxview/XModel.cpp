@@ -92,6 +92,63 @@ void XModel::modSpokeDegs(double dval)
   m_pmgen.setParam("spoke_degs", doubleToString(new_degs));
 }
 
+//-------------------------------------------------------------------
+// Procedure: setGenPoly()
+//      Note: The border index is built here, over the cover as
+//            solved. Later shifts and rotations move only the
+//            shape's transform, and queries are mapped back.
+
+void XModel::setGenPoly(XYGenPolygon gen_poly)
+{
+  m_gen_shape.setGenPoly(gen_poly);
+  m_border_index.setGenPoly(gen_poly);
+}
+
+//-------------------------------------------------------------------
+// Procedure: shiftGenPoly()
+//      Note: The cover is moved as is, not solved again.
+
+void XModel::shiftGenPoly(double dx, double dy)
+{
+  m_gen_shape.shiftHorz(dx);
+  m_gen_shape.shiftVert(dy);
+}
+
+//-------------------------------------------------------------------
+// Procedure: rotateGenPoly()
+//      Note: The cover is rotated as is, not solved again.
+
+void XModel::rotateGenPoly(double degs, double cx, double cy)
+{
+  m_gen_shape.rotate(degs, cx, cy);
+}
+
+//-------------------------------------------------------------------
+// Procedure: distRayToExit()
+
+double XModel::distRayToExit(double px, double py, double hdg) const
+{
+  double bx, by;
+  m_gen_shape.toBase(px, py, bx, by);
+  return(m_border_index.distRayToExit(bx, by, m_gen_shape.toBaseHdg(hdg)));
+}
+
+//-------------------------------------------------------------------
+// Procedure: distSeglToExit()
+
+double XModel::distSeglToExit(const XYSegList& segl, bool& exited) const
+{
+  return(m_border_index.distSeglToExit(m_gen_shape.toBase(segl), exited));
+}
+
+//-------------------------------------------------------------------
+// Procedure: distSeglrToExit()
+
+double XModel::distSeglrToExit(const XYSeglr& seglr) const
+{
+  return(m_border_index.distSeglrToExit(m_gen_shape.toBase(seglr)));
+}
+
 //-------------------------------------------------------------------
 // Procedure: getPlatModel()
 
@@ -15,6 +15,8 @@
 #include "PMGen_Dubins.h"
 #include "PlatModel.h"
 #include "XYGenPolygon.h"
+#include "GenPolyShape.h"
+#include "BorderIndex.h"
 
 class XModel {
 public:
@@ -43,9 +45,20 @@ public:
   void modOSV(double v) {m_osv += v;}
   
   // Setters for XYGenPoly
-  void setGenPoly(XYGenPolygon gp) {m_gen_poly=gp;}
+  void setGenPoly(XYGenPolygon gp);
+  void shiftGenPoly(double dx, double dy);
+  void rotateGenPoly(double degs, double cx, double cy);
 
-  XYGenPolygon getGenPoly() const {return(m_gen_poly);}
+  const XYGenPolygon& getGenPoly() const {return(m_gen_shape.getGenPoly());}
+
+  const std::vector<XYPolygon>& getCoverPolys() const
+  {return(m_gen_shape.getCoverPolys());}
+
+  // Exit distances from the border index, queried in the frame
+  // of the solved cover
+  double distRayToExit(double px, double py, double hdg) const;
+  double distSeglToExit(const XYSegList&, bool& exited) const;
+  double distSeglrToExit(const XYSeglr&) const;
 
   double getDesHdg() const {return(m_des_hdg);}
   double getOSX() const    {return(m_osx);}
@@ -66,6 +79,7 @@ protected:
 
   PMGen_Dubins m_pmgen;
 
-  XYGenPolygon m_gen_poly;
+  GenPolyShape m_gen_shape;
+  BorderIndex  m_border_index;
 };
 #endif
@@ -0,0 +1,606 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: BorderIndex.cpp                                      */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include "BorderIndex.h"
+#include "GeomUtils.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+BorderIndex::BorderIndex()
+{
+  m_cell_density = 1.0;
+  clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void BorderIndex::clear()
+{
+  m_vx.clear();
+  m_vy.clear();
+  m_cell_start.clear();
+  m_cell_edges.clear();
+
+  m_min_x = 0;
+  m_min_y = 0;
+  m_max_x = 0;
+  m_max_y = 0;
+  m_cell_size = 1;
+  m_cols = 0;
+  m_rows = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: setGenPoly()
+
+void BorderIndex::setGenPoly(const XYGenPolygon& gpoly)
+{
+  setBorder(gpoly.getSegList());
+}
+
+//---------------------------------------------------------------
+// Procedure: setBorder()
+//   Purpose: Build the grid. The cell size is chosen so that the
+//            number of cells is roughly m_cell_density times the
+//            number of edges, i.e., about one edge per cell.
+
+void BorderIndex::setBorder(const XYSegList& segl)
+{
+  clear();
+  if(segl.size() < 3)
+    return;
+
+  for(unsigned int i=0; i<segl.size(); i++) {
+    m_vx.push_back(segl.get_vx(i));
+    m_vy.push_back(segl.get_vy(i));
+  }
+
+  m_min_x = *min_element(m_vx.begin(), m_vx.end());
+  m_max_x = *max_element(m_vx.begin(), m_vx.end());
+  m_min_y = *min_element(m_vy.begin(), m_vy.end());
+  m_max_y = *max_element(m_vy.begin(), m_vy.end());
+
+  double wid = m_max_x - m_min_x;
+  double hgt = m_max_y - m_min_y;
+  double cells = m_cell_density * (double)(m_vx.size());
+  if(cells < 1)
+    cells = 1;
+
+  m_cell_size = sqrt((wid * hgt) / cells);
+  if(m_cell_size <= 0)
+    m_cell_size = max(wid, hgt) / cells;
+  if(m_cell_size <= 0)
+    m_cell_size = 1;
+
+  m_cols = (int)(wid / m_cell_size) + 1;
+  m_rows = (int)(hgt / m_cell_size) + 1;
+
+  // Part 1: Count the edges per cell, conservatively using the
+  // bounding box of each edge.
+  unsigned int vsize = m_vx.size();
+  vector<unsigned int> counts(m_cols * m_rows, 0);
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int j = (i+1) % vsize;
+    int c1 = colOf(min(m_vx[i], m_vx[j]));
+    int c2 = colOf(max(m_vx[i], m_vx[j]));
+    int r1 = rowOf(min(m_vy[i], m_vy[j]));
+    int r2 = rowOf(max(m_vy[i], m_vy[j]));
+    for(int r=r1; r<=r2; r++)
+      for(int c=c1; c<=c2; c++)
+	counts[r*m_cols + c]++;
+  }
+
+  // Part 2: Convert counts to offsets and fill
+  m_cell_start.assign(m_cols * m_rows + 1, 0);
+  for(unsigned int k=0; k<counts.size(); k++)
+    m_cell_start[k+1] = m_cell_start[k] + counts[k];
+  m_cell_edges.assign(m_cell_start.back(), 0);
+
+  vector<unsigned int> fill(m_cell_start.begin(), m_cell_start.end()-1);
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int j = (i+1) % vsize;
+    int c1 = colOf(min(m_vx[i], m_vx[j]));
+    int c2 = colOf(max(m_vx[i], m_vx[j]));
+    int r1 = rowOf(min(m_vy[i], m_vy[j]));
+    int r2 = rowOf(max(m_vy[i], m_vy[j]));
+    for(int r=r1; r<=r2; r++)
+      for(int c=c1; c<=c2; c++)
+	m_cell_edges[fill[r*m_cols + c]++] = i;
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: colOf(), rowOf()
+
+int BorderIndex::colOf(double px) const
+{
+  int col = (int)(floor((px - m_min_x) / m_cell_size));
+  if(col < 0)
+    return(0);
+  if(col >= m_cols)
+    return(m_cols-1);
+  return(col);
+}
+
+int BorderIndex::rowOf(double py) const
+{
+  int row = (int)(floor((py - m_min_y) / m_cell_size));
+  if(row < 0)
+    return(0);
+  if(row >= m_rows)
+    return(m_rows-1);
+  return(row);
+}
+
+//---------------------------------------------------------------
+// Procedure: contains()
+//   Purpose: Even-odd test on the border. Only edges stored in the
+//            cells of the grid row to the right of the point can
+//            cross the horizontal test ray.
+
+bool BorderIndex::contains(double px, double py) const
+{
+  if(m_vx.size() < 3)
+    return(false);
+  if((px < m_min_x) || (px > m_max_x) || (py < m_min_y) || (py > m_max_y))
+    return(false);
+
+  int row = rowOf(py);
+  vector<unsigned int> cands;
+  for(int c=colOf(px); c<m_cols; c++) {
+    unsigned int k = row*m_cols + c;
+    for(unsigned int e=m_cell_start[k]; e<m_cell_start[k+1]; e++)
+      cands.push_back(m_cell_edges[e]);
+  }
+  sort(cands.begin(), cands.end());
+  cands.erase(unique(cands.begin(), cands.end()), cands.end());
+
+  unsigned int vsize = m_vx.size();
+  bool inside = false;
+  for(unsigned int n=0; n<cands.size(); n++) {
+    unsigned int i = cands[n];
+    unsigned int j = (i+1) % vsize;
+    if((m_vy[i] > py) != (m_vy[j] > py)) {
+      double ix = m_vx[i] + (py - m_vy[i]) * (m_vx[j] - m_vx[i]) /
+	(m_vy[j] - m_vy[i]);
+      if(ix > px)
+	inside = !inside;
+    }
+  }
+  return(inside);
+}
+
+//---------------------------------------------------------------
+// Procedure: containsLinear()
+
+bool BorderIndex::containsLinear(double px, double py) const
+{
+  unsigned int vsize = m_vx.size();
+  if(vsize < 3)
+    return(false);
+
+  bool inside = false;
+  for(unsigned int i=0; i<vsize; i++) {
+    unsigned int j = (i+1) % vsize;
+    if((m_vy[i] > py) != (m_vy[j] > py)) {
+      double ix = m_vx[i] + (py - m_vy[i]) * (m_vx[j] - m_vx[i]) /
+	(m_vy[j] - m_vy[i]);
+      if(ix > px)
+	inside = !inside;
+    }
+  }
+  return(inside);
+}
+
+//---------------------------------------------------------------
+// Procedure: distRayToExit()
+//   Purpose: Distance along the ray from (px,py) at heading hdg
+//            until it first crosses the border. Zero if the point
+//            is not inside. -1 if the index is empty.
+
+double BorderIndex::distRayToExit(double px, double py, double hdg) const
+{
+  if(m_vx.size() < 3)
+    return(-1);
+  if(!contains(px, py))
+    return(0);
+
+  double rads = hdg * M_PI / 180.0;
+  double hit_t = 0;
+  if(firstHit(px, py, sin(rads), cos(rads), -1, hit_t))
+    return(hit_t);
+  return(0);
+}
+
+//---------------------------------------------------------------
+// Procedure: distRayToBorder()
+//   Purpose: Distance along the ray to the first border crossing,
+//            regardless of whether the point is inside. Returns -1
+//            if the ray never meets the border.
+
+double BorderIndex::distRayToBorder(double px, double py, double hdg) const
+{
+  double rads = hdg * M_PI / 180.0;
+  double hit_t = 0;
+  if(firstHit(px, py, sin(rads), cos(rads), -1, hit_t))
+    return(hit_t);
+  return(-1);
+}
+
+//---------------------------------------------------------------
+// Procedure: distRayToExitLinear()
+
+double BorderIndex::distRayToExitLinear(double px, double py,
+					double hdg) const
+{
+  if(m_vx.size() < 3)
+    return(-1);
+  if(!containsLinear(px, py))
+    return(0);
+
+  double rads = hdg * M_PI / 180.0;
+  double hit_t = 0;
+  if(firstHitLinear(px, py, sin(rads), cos(rads), -1, hit_t))
+    return(hit_t);
+  return(0);
+}
+
+//---------------------------------------------------------------
+// Procedure: distSeglToExit()
+//   Purpose: Distance along the seglist until it first crosses the
+//            border. If it never crosses, the full length is
+//            returned and exited is false.
+
+double BorderIndex::distSeglToExit(const XYSegList& segl, bool& exited) const
+{
+  exited = false;
+  if((m_vx.size() < 3) || (segl.size() == 0))
+    return(-1);
+
+  if(!contains(segl.get_vx(0), segl.get_vy(0))) {
+    exited = true;
+    return(0);
+  }
+
+  double dist = 0;
+  for(unsigned int i=0; i+1<segl.size(); i++) {
+    double x1 = segl.get_vx(i);
+    double y1 = segl.get_vy(i);
+    double x2 = segl.get_vx(i+1);
+    double y2 = segl.get_vy(i+1);
+    double len = hypot(x2-x1, y2-y1);
+    if(len <= 0)
+      continue;
+
+    double hit_t = 0;
+    if(firstHit(x1, y1, (x2-x1)/len, (y2-y1)/len, len, hit_t)) {
+      exited = true;
+      return(dist + hit_t);
+    }
+    dist += len;
+  }
+  return(dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: distSeglrToExit()
+
+double BorderIndex::distSeglrToExit(const XYSeglr& seglr) const
+{
+  XYSegList segl = seglr.getBaseSegList();
+
+  bool exited = false;
+  double dist = distSeglToExit(segl, exited);
+  if(exited || (dist < 0))
+    return(dist);
+
+  double rx = seglr.getRayBaseX();
+  double ry = seglr.getRayBaseY();
+  double rads = seglr.getRayAngle() * M_PI / 180.0;
+
+  double hit_t = 0;
+  if(firstHit(rx, ry, sin(rads), cos(rads), -1, hit_t))
+    dist += hit_t;
+  return(dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: distToBorder()
+//   Purpose: Distance from the point to the nearest border edge.
+//            Cells are searched in rings around the cell holding
+//            the point, stopping once no cell in a ring is closer
+//            than the best edge found so far.
+
+double BorderIndex::distToBorder(double px, double py) const
+{
+  if(m_cols == 0)
+    return(-1);
+
+  int col = colOf(px);
+  int row = rowOf(py);
+  int max_ring = max(m_cols, m_rows);
+
+  unsigned int vsize = m_vx.size();
+  double best = -1;
+  for(int r=0; r<=max_ring; r++) {
+    double ring_min = -1;
+    for(int j=row-r; j<=row+r; j++) {
+      if((j < 0) || (j >= m_rows))
+	continue;
+      for(int i=col-r; i<=col+r; i++) {
+	if((i < 0) || (i >= m_cols))
+	  continue;
+	// Only the cells on the perimeter of the ring
+	if((j != row-r) && (j != row+r) && (i != col-r) && (i != col+r))
+	  continue;
+
+	double cdist = distToCell(px, py, i, j);
+	if((ring_min < 0) || (cdist < ring_min))
+	  ring_min = cdist;
+	if((best >= 0) && (cdist >= best))
+	  continue;
+
+	unsigned int k = j*m_cols + i;
+	for(unsigned int e=m_cell_start[k]; e<m_cell_start[k+1]; e++) {
+	  unsigned int ix = m_cell_edges[e];
+	  unsigned int jx = (ix+1) % vsize;
+	  double dist = distPointToSeg(m_vx[ix], m_vy[ix],
+				       m_vx[jx], m_vy[jx], px, py);
+	  if((best < 0) || (dist < best))
+	    best = dist;
+	}
+      }
+    }
+    if((ring_min < 0) || ((best >= 0) && (ring_min >= best)))
+      break;
+  }
+  return(best);
+}
+
+//---------------------------------------------------------------
+// Procedure: distToCell()
+//   Purpose: Distance from the point to the box of the given cell,
+//            zero if the point is in the cell.
+
+double BorderIndex::distToCell(double px, double py, int col, int row) const
+{
+  double x1 = m_min_x + col * m_cell_size;
+  double y1 = m_min_y + row * m_cell_size;
+  double x2 = x1 + m_cell_size;
+  double y2 = y1 + m_cell_size;
+
+  double dx = 0;
+  if(px < x1)
+    dx = x1 - px;
+  else if(px > x2)
+    dx = px - x2;
+
+  double dy = 0;
+  if(py < y1)
+    dy = y1 - py;
+  else if(py > y2)
+    dy = py - y2;
+
+  return(hypot(dx, dy));
+}
+
+//---------------------------------------------------------------
+// Procedure: crossesBox()
+//   Purpose: Determine if any border edge meets the given box,
+//            edges along the box boundary included. Only edges
+//            stored in the grid cells under the box are tested,
+//            each by clipping it to the box.
+
+bool BorderIndex::crossesBox(double x1, double y1,
+			     double x2, double y2) const
+{
+  if(m_cols == 0)
+    return(false);
+  if((x2 < m_min_x) || (x1 > m_max_x) || (y2 < m_min_y) || (y1 > m_max_y))
+    return(false);
+
+  unsigned int vsize = m_vx.size();
+  for(int j=rowOf(y1); j<=rowOf(y2); j++) {
+    for(int i=colOf(x1); i<=colOf(x2); i++) {
+      unsigned int k = j*m_cols + i;
+      for(unsigned int e=m_cell_start[k]; e<m_cell_start[k+1]; e++) {
+	unsigned int ix = m_cell_edges[e];
+	unsigned int jx = (ix+1) % vsize;
+	double ax = m_vx[ix];
+	double ay = m_vy[ix];
+	double dx = m_vx[jx] - ax;
+	double dy = m_vy[jx] - ay;
+
+	// Clip the edge parameter range [0,1] to each slab
+	double t1 = 0;
+	double t2 = 1;
+	double p[4] = {-dx, dx, -dy, dy};
+	double q[4] = {ax-x1, x2-ax, ay-y1, y2-ay};
+	for(unsigned int n=0; (n<4) && (t1 <= t2); n++) {
+	  if(p[n] == 0) {
+	    if(q[n] < 0)
+	      t1 = 2;
+	  }
+	  else if(p[n] < 0)
+	    t1 = max(t1, q[n] / p[n]);
+	  else
+	    t2 = min(t2, q[n] / p[n]);
+	}
+	if(t1 <= t2)
+	  return(true);
+      }
+    }
+  }
+  return(false);
+}
+
+//---------------------------------------------------------------
+// Procedure: edgeHit()
+//   Purpose: Intersect the ray p + t*u with border edge ix. On a
+//            hit, hit_t is set to the (non-negative) ray distance.
+
+bool BorderIndex::edgeHit(unsigned int ix, double px, double py,
+			  double ux, double uy, double& hit_t) const
+{
+  unsigned int jx = (ix+1) % m_vx.size();
+  double ex = m_vx[jx] - m_vx[ix];
+  double ey = m_vy[jx] - m_vy[ix];
+
+  double denom = ux*ey - uy*ex;
+  if(denom == 0)
+    return(false);
+
+  double wx = m_vx[ix] - px;
+  double wy = m_vy[ix] - py;
+
+  double t = (wx*ey - wy*ex) / denom;
+  double s = (wx*uy - wy*ux) / denom;
+  if((t < 0) || (s < 0) || (s > 1))
+    return(false);
+
+  hit_t = t;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: firstHit()
+//   Purpose: Find the nearest border crossing along the ray from
+//            (px,py) in unit direction (ux,uy), walking the grid
+//            cells in ray order. A tmax < 0 means unbounded.
+
+bool BorderIndex::firstHit(double px, double py, double ux, double uy,
+			   double tmax, double& hit_t) const
+{
+  if(m_cols == 0)
+    return(false);
+
+  // Part 1: Clip the ray to the grid extent (slab method)
+  double t0 = 0;
+  double t1 = (tmax < 0) ? 1e30 : tmax;
+  double gx2 = m_min_x + m_cols * m_cell_size;
+  double gy2 = m_min_y + m_rows * m_cell_size;
+  if(ux == 0) {
+    if((px < m_min_x) || (px > gx2))
+      return(false);
+  }
+  else {
+    double ta = (m_min_x - px) / ux;
+    double tb = (gx2 - px) / ux;
+    t0 = max(t0, min(ta, tb));
+    t1 = min(t1, max(ta, tb));
+  }
+  if(uy == 0) {
+    if((py < m_min_y) || (py > gy2))
+      return(false);
+  }
+  else {
+    double ta = (m_min_y - py) / uy;
+    double tb = (gy2 - py) / uy;
+    t0 = max(t0, min(ta, tb));
+    t1 = min(t1, max(ta, tb));
+  }
+  if(t0 > t1)
+    return(false);
+
+  // Part 2: Set up the DDA walk from the entry cell
+  int col = colOf(px + t0*ux);
+  int row = rowOf(py + t0*uy);
+
+  int step_c = (ux > 0) ? 1 : -1;
+  int step_r = (uy > 0) ? 1 : -1;
+
+  double inf = 1e30;
+  double tdelta_c = (ux != 0) ? (m_cell_size / fabs(ux)) : inf;
+  double tdelta_r = (uy != 0) ? (m_cell_size / fabs(uy)) : inf;
+
+  double tnext_c = inf;
+  if(ux > 0)
+    tnext_c = (m_min_x + (col+1)*m_cell_size - px) / ux;
+  else if(ux < 0)
+    tnext_c = (m_min_x + col*m_cell_size - px) / ux;
+
+  double tnext_r = inf;
+  if(uy > 0)
+    tnext_r = (m_min_y + (row+1)*m_cell_size - py) / uy;
+  else if(uy < 0)
+    tnext_r = (m_min_y + row*m_cell_size - py) / uy;
+
+  // Part 3: Walk cells. A hit found in a cell before the ray leaves
+  // that cell cannot be beaten by an edge in a later cell.
+  bool   found  = false;
+  double best_t = 0;
+  while(true) {
+    unsigned int k = row*m_cols + col;
+    for(unsigned int e=m_cell_start[k]; e<m_cell_start[k+1]; e++) {
+      double t = 0;
+      if(edgeHit(m_cell_edges[e], px, py, ux, uy, t)) {
+	if((tmax >= 0) && (t > tmax))
+	  continue;
+	if(!found || (t < best_t)) {
+	  best_t = t;
+	  found  = true;
+	}
+      }
+    }
+
+    double tcell_exit = min(tnext_c, tnext_r);
+    if(found && (best_t <= tcell_exit))
+      break;
+    if(tcell_exit > t1)
+      break;
+
+    if(tnext_c < tnext_r) {
+      col += step_c;
+      tnext_c += tdelta_c;
+    }
+    else {
+      row += step_r;
+      tnext_r += tdelta_r;
+    }
+    if((col < 0) || (col >= m_cols) || (row < 0) || (row >= m_rows))
+      break;
+  }
+
+  if(found)
+    hit_t = best_t;
+  return(found);
+}
+
+//---------------------------------------------------------------
+// Procedure: firstHitLinear()
+
+bool BorderIndex::firstHitLinear(double px, double py, double ux, double uy,
+				 double tmax, double& hit_t) const
+{
+  bool   found  = false;
+  double best_t = 0;
+  for(unsigned int i=0; i<m_vx.size(); i++) {
+    double t = 0;
+    if(edgeHit(i, px, py, ux, uy, t)) {
+      if((tmax >= 0) && (t > tmax))
+	continue;
+      if(!found || (t < best_t)) {
+	best_t = t;
+	found  = true;
+      }
+    }
+  }
+
+  if(found)
+    hit_t = best_t;
+  return(found);
+}
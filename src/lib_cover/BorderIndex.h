@@ -0,0 +1,93 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: BorderIndex.h                                        */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef BORDER_INDEX_HEADER
+#define BORDER_INDEX_HEADER
+
+#include <vector>
+#include "XYSegList.h"
+#include "XYSeglr.h"
+#include "XYGenPolygon.h"
+
+//---------------------------------------------------------------
+// A uniform grid over the border edges of a genpoly. Each cell
+// holds the edges whose bounding box overlaps the cell. Ray
+// queries walk only the cells crossed by the ray (2D DDA) and
+// stop at the first cell holding a hit, so the cost scales with
+// the number of cells crossed rather than the number of edges.
+
+class BorderIndex {
+ public:
+  BorderIndex();
+  ~BorderIndex() {}
+
+  void   setGenPoly(const XYGenPolygon&);
+  void   setBorder(const XYSegList&);
+  void   setCellDensity(double v) {m_cell_density = v;}
+  void   clear();
+
+  bool   contains(double px, double py) const;
+
+  double distRayToExit(double px, double py, double hdg) const;
+  double distRayToBorder(double px, double py, double hdg) const;
+  double distSeglToExit(const XYSegList&, bool& exited) const;
+  double distSeglrToExit(const XYSeglr&) const;
+
+  double distToBorder(double px, double py) const;
+  bool   crossesBox(double x1, double y1, double x2, double y2) const;
+
+  // Reference versions walking every border edge
+  double distRayToExitLinear(double px, double py, double hdg) const;
+  bool   containsLinear(double px, double py) const;
+
+  unsigned int size() const      {return(m_vx.size());}
+  unsigned int cellCount() const {return(m_cols * m_rows);}
+
+  double getMinX() const {return(m_min_x);}
+  double getMinY() const {return(m_min_y);}
+  double getMaxX() const {return(m_max_x);}
+  double getMaxY() const {return(m_max_y);}
+
+ protected:
+  bool   firstHit(double px, double py, double ux, double uy,
+		  double tmax, double& hit_t) const;
+  bool   firstHitLinear(double px, double py, double ux, double uy,
+			double tmax, double& hit_t) const;
+  bool   edgeHit(unsigned int ix, double px, double py,
+		 double ux, double uy, double& hit_t) const;
+
+  double distToCell(double px, double py, int col, int row) const;
+
+  int    colOf(double px) const;
+  int    rowOf(double py) const;
+
+ protected: // Border vertices, edge i runs from vertex i to i+1
+  std::vector<double> m_vx;
+  std::vector<double> m_vy;
+
+ protected: // Grid in compressed form: cell c holds the edges
+            // m_cell_edges[m_cell_start[c]...m_cell_start[c+1]-1]
+  double m_min_x;
+  double m_min_y;
+  double m_max_x;
+  double m_max_y;
+  double m_cell_size;
+  int    m_cols;
+  int    m_rows;
+
+  std::vector<unsigned int> m_cell_start;
+  std::vector<unsigned int> m_cell_edges;
+
+ protected: // Config vars
+  double m_cell_density;  // Target number of cells per edge
+};
+
+#endif
@@ -0,0 +1,327 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: CoverIndex.cpp                                       */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include <queue>
+#include "CoverIndex.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void CoverIndex::clear()
+{
+  m_polys.clear();
+  m_min_x.clear();
+  m_min_y.clear();
+  m_max_x.clear();
+  m_max_y.clear();
+
+  m_order.clear();
+  m_node_min_x.clear();
+  m_node_min_y.clear();
+  m_node_max_x.clear();
+  m_node_max_y.clear();
+  m_node_right.clear();
+  m_node_first.clear();
+  m_node_count.clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: setGenPoly()
+
+void CoverIndex::setGenPoly(const XYGenPolygon& gpoly)
+{
+  setCoverPolys(gpoly.getCoverPolys());
+}
+
+//---------------------------------------------------------------
+// Procedure: setCoverPolys()
+
+void CoverIndex::setCoverPolys(const vector<XYPolygon>& polys)
+{
+  clear();
+  m_polys = polys;
+  for(unsigned int i=0; i<m_polys.size(); i++) {
+    m_min_x.push_back(m_polys[i].get_min_x());
+    m_min_y.push_back(m_polys[i].get_min_y());
+    m_max_x.push_back(m_polys[i].get_max_x());
+    m_max_y.push_back(m_polys[i].get_max_y());
+    m_order.push_back(i);
+  }
+
+  if(m_polys.size() > 0)
+    buildNode(0, m_polys.size());
+}
+
+//---------------------------------------------------------------
+// Procedure: buildNode()
+//   Purpose: Add the BVH node over pieces m_order[first...] and,
+//            unless few enough for a leaf, split them at the median
+//            box center along the longer axis of the node box.
+//   Returns: The index of the new node.
+
+unsigned int CoverIndex::buildNode(unsigned int first, unsigned int count)
+{
+  double min_x = m_min_x[m_order[first]];
+  double min_y = m_min_y[m_order[first]];
+  double max_x = m_max_x[m_order[first]];
+  double max_y = m_max_y[m_order[first]];
+  for(unsigned int k=first+1; k<(first+count); k++) {
+    min_x = min(min_x, m_min_x[m_order[k]]);
+    min_y = min(min_y, m_min_y[m_order[k]]);
+    max_x = max(max_x, m_max_x[m_order[k]]);
+    max_y = max(max_y, m_max_y[m_order[k]]);
+  }
+
+  unsigned int node = m_node_first.size();
+  m_node_min_x.push_back(min_x);
+  m_node_min_y.push_back(min_y);
+  m_node_max_x.push_back(max_x);
+  m_node_max_y.push_back(max_y);
+  m_node_right.push_back(0);
+  m_node_first.push_back(first);
+  m_node_count.push_back(count);
+  if(count <= 4)
+    return(node);
+
+  bool split_x = ((max_x - min_x) >= (max_y - min_y));
+  vector<pair<double,unsigned int> > centers;
+  for(unsigned int k=first; k<(first+count); k++) {
+    unsigned int ix = m_order[k];
+    double center = m_min_y[ix] + m_max_y[ix];
+    if(split_x)
+      center = m_min_x[ix] + m_max_x[ix];
+    centers.push_back(make_pair(center, ix));
+  }
+  unsigned int half = count / 2;
+  nth_element(centers.begin(), centers.begin() + half, centers.end());
+  for(unsigned int k=0; k<count; k++)
+    m_order[first+k] = centers[k].second;
+
+  m_node_count[node] = 0;
+  buildNode(first, half);
+  m_node_right[node] = buildNode(first + half, count - half);
+  return(node);
+}
+
+//---------------------------------------------------------------
+// Procedure: boxDist()
+//   Purpose: Distance between the box spanned by x1,y1,x2,y2 and
+//            the box bx1,by1,bx2,by2. Zero if they overlap. Since a
+//            segment lies within its own box, this is a lower bound
+//            on the distance from the segment to anything in the
+//            other box.
+
+double CoverIndex::boxDist(double bx1, double by1, double bx2, double by2,
+			   double x1, double y1, double x2, double y2) const
+{
+  double dx = 0;
+  if(max(x1,x2) < bx1)
+    dx = bx1 - max(x1,x2);
+  else if(min(x1,x2) > bx2)
+    dx = min(x1,x2) - bx2;
+
+  double dy = 0;
+  if(max(y1,y2) < by1)
+    dy = by1 - max(y1,y2);
+  else if(min(y1,y2) > by2)
+    dy = min(y1,y2) - by2;
+
+  return(hypot(dx, dy));
+}
+
+//---------------------------------------------------------------
+// Procedure: pieceBoxDist(), nodeBoxDist()
+
+double CoverIndex::pieceBoxDist(unsigned int ix, double x1, double y1,
+				double x2, double y2) const
+{
+  return(boxDist(m_min_x[ix], m_min_y[ix], m_max_x[ix], m_max_y[ix],
+		 x1, y1, x2, y2));
+}
+
+double CoverIndex::nodeBoxDist(unsigned int ix, double x1, double y1,
+			       double x2, double y2) const
+{
+  return(boxDist(m_node_min_x[ix], m_node_min_y[ix],
+		 m_node_max_x[ix], m_node_max_y[ix], x1, y1, x2, y2));
+}
+
+//---------------------------------------------------------------
+// Procedure: pieceDist()
+//   Purpose: Exact distance to piece ix from the segment, or from
+//            the point if the segment has no length.
+
+double CoverIndex::pieceDist(unsigned int ix, double x1, double y1,
+			     double x2, double y2) const
+{
+  if((x1 == x2) && (y1 == y2))
+    return(m_polys[ix].dist_to_poly(x1, y1));
+  return(m_polys[ix].dist_to_poly(x1, y1, x2, y2));
+}
+
+//---------------------------------------------------------------
+// Procedure: nearest()
+//   Purpose: Best-first walk of the BVH. Nodes wait in a queue
+//            ordered by their box bound, and the walk ends when the
+//            nearest waiting bound is no better than the best
+//            piece distance found.
+//   Returns: -1 if there are no cover pieces
+
+double CoverIndex::nearest(double x1, double y1, double x2, double y2) const
+{
+  if(m_node_first.size() == 0)
+    return(-1);
+
+  typedef pair<double, unsigned int> QEntry;
+  priority_queue<QEntry, vector<QEntry>, greater<QEntry> > open;
+  open.push(QEntry(nodeBoxDist(0, x1, y1, x2, y2), 0));
+
+  double min_dist = -1;
+  while(!open.empty()) {
+    QEntry entry = open.top();
+    open.pop();
+    if((min_dist >= 0) && (entry.first >= min_dist))
+      break;
+
+    unsigned int node = entry.second;
+    if(m_node_count[node] == 0) {
+      unsigned int left  = node + 1;
+      unsigned int right = m_node_right[node];
+      open.push(QEntry(nodeBoxDist(left, x1, y1, x2, y2), left));
+      open.push(QEntry(nodeBoxDist(right, x1, y1, x2, y2), right));
+      continue;
+    }
+
+    unsigned int first = m_node_first[node];
+    for(unsigned int k=first; k<(first + m_node_count[node]); k++) {
+      unsigned int ix = m_order[k];
+      if((min_dist >= 0) && (pieceBoxDist(ix, x1, y1, x2, y2) >= min_dist))
+	continue;
+      double dist = pieceDist(ix, x1, y1, x2, y2);
+      if((min_dist < 0) || (dist < min_dist))
+	min_dist = dist;
+    }
+    if(min_dist == 0)
+      break;
+  }
+
+  return(min_dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: within()
+//   Purpose: Depth-first walk of the BVH, skipping nodes whose box
+//            is beyond the given distance, and returning on the
+//            first piece found within it.
+
+bool CoverIndex::within(double x1, double y1, double x2, double y2,
+			double dist) const
+{
+  if(m_node_first.size() == 0)
+    return(false);
+
+  vector<unsigned int> stack(1, 0);
+  while(!stack.empty()) {
+    unsigned int node = stack.back();
+    stack.pop_back();
+    if(nodeBoxDist(node, x1, y1, x2, y2) > dist)
+      continue;
+
+    if(m_node_count[node] == 0) {
+      stack.push_back(m_node_right[node]);
+      stack.push_back(node + 1);
+      continue;
+    }
+
+    unsigned int first = m_node_first[node];
+    for(unsigned int k=first; k<(first + m_node_count[node]); k++) {
+      unsigned int ix = m_order[k];
+      if(pieceBoxDist(ix, x1, y1, x2, y2) > dist)
+	continue;
+      if(pieceDist(ix, x1, y1, x2, y2) <= dist)
+	return(true);
+    }
+  }
+  return(false);
+}
+
+//---------------------------------------------------------------
+// Procedure: dist_to_poly()
+//   Returns: -1 if there are no cover pieces
+
+double CoverIndex::dist_to_poly(double px, double py) const
+{
+  return(nearest(px, py, px, py));
+}
+
+//---------------------------------------------------------------
+// Procedure: dist_to_poly()
+//   Returns: -1 if there are no cover pieces
+
+double CoverIndex::dist_to_poly(double x1, double y1,
+				double x2, double y2) const
+{
+  return(nearest(x1, y1, x2, y2));
+}
+
+//---------------------------------------------------------------
+// Procedure: withinDist()
+//   Purpose: Determine if dist_to_poly() is no more than the given
+//            distance, returning on the first piece found within.
+
+bool CoverIndex::withinDist(double px, double py, double dist) const
+{
+  return(within(px, py, px, py, dist));
+}
+
+//---------------------------------------------------------------
+// Procedure: withinDist()
+
+bool CoverIndex::withinDist(double x1, double y1, double x2, double y2,
+			    double dist) const
+{
+  return(within(x1, y1, x2, y2, dist));
+}
+
+//---------------------------------------------------------------
+// Procedure: distLinear()
+//   Purpose: The plain walk over every piece, as done by
+//            XYGenPolygon::dist_to_poly(). Kept for benchmarking.
+
+double CoverIndex::distLinear(double px, double py) const
+{
+  double min_dist = -1;
+  for(unsigned int i=0; i<m_polys.size(); i++) {
+    double dist = m_polys[i].dist_to_poly(px, py);
+    if((i==0) || (dist < min_dist))
+      min_dist = dist;
+  }
+  return(min_dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: distLinear()
+
+double CoverIndex::distLinear(double x1, double y1,
+			      double x2, double y2) const
+{
+  double min_dist = -1;
+  for(unsigned int i=0; i<m_polys.size(); i++) {
+    double dist = m_polys[i].dist_to_poly(x1, y1, x2, y2);
+    if((i==0) || (dist < min_dist))
+      min_dist = dist;
+  }
+  return(min_dist);
+}
@@ -0,0 +1,91 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: CoverIndex.h                                         */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef COVER_INDEX_HEADER
+#define COVER_INDEX_HEADER
+
+#include <vector>
+#include "XYPolygon.h"
+#include "XYGenPolygon.h"
+
+//---------------------------------------------------------------
+// Minimum distance queries over the convex cover pieces of a
+// genpoly, returning the same values as XYGenPolygon::dist_to_poly.
+// The piece bounding boxes are held in a static bounding volume
+// hierarchy (BVH), built once when the pieces are set by median
+// splits along the longer axis. Nodes are visited nearest-first by
+// the distance to their box, a lower bound on the distance to any
+// piece below, and the search stops once the next bound is no
+// better than the best distance found so far.
+
+class CoverIndex {
+ public:
+  CoverIndex() {}
+  ~CoverIndex() {}
+
+  void   setGenPoly(const XYGenPolygon&);
+  void   setCoverPolys(const std::vector<XYPolygon>&);
+  void   clear();
+
+  double dist_to_poly(double px, double py) const;
+  double dist_to_poly(double x1, double y1, double x2, double y2) const;
+
+  bool   withinDist(double px, double py, double dist) const;
+  bool   withinDist(double x1, double y1, double x2, double y2,
+		    double dist) const;
+
+  double distLinear(double px, double py) const;
+  double distLinear(double x1, double y1, double x2, double y2) const;
+
+  unsigned int size() const      {return(m_polys.size());}
+  unsigned int nodeCount() const {return(m_node_first.size());}
+
+ protected:
+  unsigned int buildNode(unsigned int first, unsigned int count);
+
+  double nearest(double x1, double y1, double x2, double y2) const;
+  bool   within(double x1, double y1, double x2, double y2,
+		double dist) const;
+  double pieceDist(unsigned int ix, double x1, double y1,
+		   double x2, double y2) const;
+
+  double boxDist(double bx1, double by1, double bx2, double by2,
+		 double x1, double y1, double x2, double y2) const;
+  double pieceBoxDist(unsigned int ix, double x1, double y1,
+		      double x2, double y2) const;
+  double nodeBoxDist(unsigned int ix, double x1, double y1,
+		     double x2, double y2) const;
+
+ protected: // State vars
+  std::vector<XYPolygon> m_polys;
+
+  std::vector<double> m_min_x;
+  std::vector<double> m_min_y;
+  std::vector<double> m_max_x;
+  std::vector<double> m_max_y;
+
+ protected: // BVH nodes in pre-order, so the left child of node i
+            // is node i+1. A leaf holds the pieces
+            // m_order[m_node_first[i]...+m_node_count[i]-1], an
+            // inner node has a count of zero.
+  std::vector<unsigned int> m_order;
+
+  std::vector<double> m_node_min_x;
+  std::vector<double> m_node_min_y;
+  std::vector<double> m_node_max_x;
+  std::vector<double> m_node_max_y;
+
+  std::vector<unsigned int> m_node_right;
+  std::vector<unsigned int> m_node_first;
+  std::vector<unsigned int> m_node_count;
+};
+
+#endif
@@ -0,0 +1,362 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: DistField.cpp                                        */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include "DistField.h"
+#include "GeomUtils.h"
+
+using namespace std;
+
+#define DF_INF 1e20
+
+//---------------------------------------------------------------
+// Constructor()
+
+DistField::DistField()
+{
+  m_cell_size  = 1;
+  m_padding    = 10;
+  m_exact_band = -1;  // -1 means two cells
+  clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void DistField::clear()
+{
+  m_index.clear();
+  m_border.clear();
+  m_field.clear();
+
+  m_min_x = 0;
+  m_min_y = 0;
+  m_cols  = 0;
+  m_rows  = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: setGenPoly()
+
+void DistField::setGenPoly(const XYGenPolygon& gpoly)
+{
+  setBorder(gpoly.getSegList());
+}
+
+//---------------------------------------------------------------
+// Procedure: setBorder()
+
+void DistField::setBorder(const XYSegList& segl)
+{
+  clear();
+  if(segl.size() < 3)
+    return;
+
+  m_border = segl;
+  m_index.setBorder(segl);
+  build();
+}
+
+//---------------------------------------------------------------
+// Procedure: setCellSize()
+
+void DistField::setCellSize(double dval)
+{
+  if(dval <= 0)
+    return;
+
+  m_cell_size = dval;
+  if(m_border.size() >= 3)
+    build();
+}
+
+//---------------------------------------------------------------
+// Procedure: getErrorBound()
+//   Purpose: Bound on |approx - exact| for queries served from the
+//            grid. Every border point is within half a cell
+//            diagonal of a seed, and every seed within a full cell
+//            diagonal of the border, so node values are within one
+//            diagonal of the truth. Bilinear interpolation of a
+//            1-Lipschitz field adds at most half a diagonal.
+
+double DistField::getErrorBound() const
+{
+  return(1.5 * sqrt(2.0) * m_cell_size);
+}
+
+//---------------------------------------------------------------
+// Procedure: build()
+
+void DistField::build()
+{
+  m_field.clear();
+
+  double pad = m_padding;
+  m_min_x = m_index.getMinX() - pad;
+  m_min_y = m_index.getMinY() - pad;
+  double wid = (m_index.getMaxX() + pad) - m_min_x;
+  double hgt = (m_index.getMaxY() + pad) - m_min_y;
+
+  m_cols = (unsigned int)(ceil(wid / m_cell_size)) + 1;
+  m_rows = (unsigned int)(ceil(hgt / m_cell_size)) + 1;
+
+  // Part 1: Seed nodes touching the border at zero
+  vector<float> f(m_cols * m_rows, DF_INF);
+  seedNodes(f);
+
+  // Part 2: Squared distance transform, along rows then columns
+  vector<float> line(max(m_cols, m_rows));
+  for(unsigned int j=0; j<m_rows; j++) {
+    for(unsigned int i=0; i<m_cols; i++)
+      line[i] = f[j*m_cols + i];
+    transform1D(line, m_cols);
+    for(unsigned int i=0; i<m_cols; i++)
+      f[j*m_cols + i] = line[i];
+  }
+  for(unsigned int i=0; i<m_cols; i++) {
+    for(unsigned int j=0; j<m_rows; j++)
+      line[j] = f[j*m_cols + i];
+    transform1D(line, m_rows);
+    for(unsigned int j=0; j<m_rows; j++)
+      f[j*m_cols + i] = line[j];
+  }
+
+  // Part 3: Convert to meters and apply inside/outside sign
+  for(unsigned int k=0; k<f.size(); k++)
+    f[k] = sqrt(f[k]) * m_cell_size;
+  m_field = f;
+  applySigns();
+}
+
+//---------------------------------------------------------------
+// Procedure: seedNodes()
+//   Purpose: Zero the four corner nodes of every cell the border
+//            passes through. A cell is taken as crossed if its
+//            center is within half a cell diagonal of an edge.
+
+void DistField::seedNodes(vector<float>& f) const
+{
+  double half_diag = m_cell_size * sqrt(2.0) / 2;
+
+  unsigned int vsize = m_border.size();
+  for(unsigned int k=0; k<vsize; k++) {
+    double x1 = m_border.get_vx(k);
+    double y1 = m_border.get_vy(k);
+    double x2 = m_border.get_vx((k+1) % vsize);
+    double y2 = m_border.get_vy((k+1) % vsize);
+
+    int c1 = (int)(floor((min(x1,x2) - m_min_x) / m_cell_size));
+    int c2 = (int)(floor((max(x1,x2) - m_min_x) / m_cell_size));
+    int r1 = (int)(floor((min(y1,y2) - m_min_y) / m_cell_size));
+    int r2 = (int)(floor((max(y1,y2) - m_min_y) / m_cell_size));
+    c1 = max(c1, 0);
+    r1 = max(r1, 0);
+    c2 = min(c2, (int)(m_cols) - 2);
+    r2 = min(r2, (int)(m_rows) - 2);
+
+    for(int r=r1; r<=r2; r++) {
+      for(int c=c1; c<=c2; c++) {
+	double cx = m_min_x + (c + 0.5) * m_cell_size;
+	double cy = m_min_y + (r + 0.5) * m_cell_size;
+	if(distPointToSeg(x1, y1, x2, y2, cx, cy) > half_diag)
+	  continue;
+	f[(r  )*m_cols + c  ] = 0;
+	f[(r  )*m_cols + c+1] = 0;
+	f[(r+1)*m_cols + c  ] = 0;
+	f[(r+1)*m_cols + c+1] = 0;
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: transform1D()
+//   Purpose: One dimensional squared distance transform of the
+//            sampled function f over n nodes, by the lower
+//            envelope of parabolas. Linear in n.
+
+void DistField::transform1D(vector<float>& f, unsigned int n) const
+{
+  vector<float>        d(n);
+  vector<unsigned int> v(n);
+  vector<double>       z(n+1);
+
+  unsigned int k = 0;
+  v[0] = 0;
+  z[0] = -DF_INF;
+  z[1] = DF_INF;
+  for(unsigned int q=1; q<n; q++) {
+    double p = v[k];
+    double s = ((f[q] + (double)(q)*q) - (f[v[k]] + p*p)) / (2.0*q - 2.0*p);
+    while(s <= z[k]) {
+      k--;
+      p = v[k];
+      s = ((f[q] + (double)(q)*q) - (f[v[k]] + p*p)) / (2.0*q - 2.0*p);
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k+1] = DF_INF;
+  }
+
+  k = 0;
+  for(unsigned int q=0; q<n; q++) {
+    while(z[k+1] < q)
+      k++;
+    double dq = (double)(q) - v[k];
+    d[q] = (float)(dq*dq + f[v[k]]);
+  }
+  for(unsigned int q=0; q<n; q++)
+    f[q] = d[q];
+}
+
+//---------------------------------------------------------------
+// Procedure: applySigns()
+//   Purpose: Negate the nodes inside the border. For each grid row
+//            the border crossings of the row line are sorted, and
+//            nodes are classified by crossing parity in one sweep.
+
+void DistField::applySigns()
+{
+  unsigned int vsize = m_border.size();
+  for(unsigned int j=0; j<m_rows; j++) {
+    double py = m_min_y + j * m_cell_size;
+
+    vector<double> xings;
+    for(unsigned int k=0; k<vsize; k++) {
+      double x1 = m_border.get_vx(k);
+      double y1 = m_border.get_vy(k);
+      double x2 = m_border.get_vx((k+1) % vsize);
+      double y2 = m_border.get_vy((k+1) % vsize);
+      if((y1 > py) != (y2 > py))
+	xings.push_back(x1 + (py - y1) * (x2 - x1) / (y2 - y1));
+    }
+    sort(xings.begin(), xings.end());
+
+    unsigned int passed = 0;
+    for(unsigned int i=0; i<m_cols; i++) {
+      double px = m_min_x + i * m_cell_size;
+      while((passed < xings.size()) && (xings[passed] < px))
+	passed++;
+      if((passed % 2) == 1)
+	m_field[j*m_cols + i] = -m_field[j*m_cols + i];
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: cellOf()
+
+bool DistField::cellOf(double px, double py, unsigned int& i,
+		       unsigned int& j, double& fx, double& fy) const
+{
+  if(m_field.size() == 0)
+    return(false);
+
+  double gx = (px - m_min_x) / m_cell_size;
+  double gy = (py - m_min_y) / m_cell_size;
+  if((gx < 0) || (gy < 0))
+    return(false);
+
+  i = (unsigned int)(gx);
+  j = (unsigned int)(gy);
+  if(((i+1) >= m_cols) || ((j+1) >= m_rows))
+    return(false);
+
+  fx = gx - i;
+  fy = gy - j;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: signedDist()
+//   Purpose: Approximate signed distance to the border, negative
+//            inside. Exact near the border or off the grid.
+
+double DistField::signedDist(double px, double py) const
+{
+  unsigned int i, j;
+  double fx, fy;
+  if(!cellOf(px, py, i, j, fx, fy))
+    return(signedDistExact(px, py));
+
+  const float* row1 = &m_field[j*m_cols + i];
+  const float* row2 = row1 + m_cols;
+
+  double v = (1-fy) * ((1-fx)*row1[0] + fx*row1[1]) +
+    fy * ((1-fx)*row2[0] + fx*row2[1]);
+
+  double band = m_exact_band;
+  if(band < 0)
+    band = 2 * m_cell_size;
+  if(fabs(v) < band)
+    return(signedDistExact(px, py));
+
+  return(v);
+}
+
+//---------------------------------------------------------------
+// Procedure: dist()
+
+double DistField::dist(double px, double py) const
+{
+  return(fabs(signedDist(px, py)));
+}
+
+//---------------------------------------------------------------
+// Procedure: signedDistExact()
+
+double DistField::signedDistExact(double px, double py) const
+{
+  double dist = m_index.distToBorder(px, py);
+  if(dist < 0)
+    return(dist);
+  if(m_index.contains(px, py))
+    return(-dist);
+  return(dist);
+}
+
+//---------------------------------------------------------------
+// Procedure: gradient()
+//   Purpose: Gradient of the signed distance, pointing away from
+//            the border on the outside and toward it on the inside.
+//            Near the border it is taken by central differences of
+//            the exact distance.
+
+bool DistField::gradient(double px, double py, double& gx, double& gy) const
+{
+  if(m_border.size() < 3)
+    return(false);
+
+  unsigned int i, j;
+  double fx, fy;
+  double band = m_exact_band;
+  if(band < 0)
+    band = 2 * m_cell_size;
+
+  if(cellOf(px, py, i, j, fx, fy)) {
+    const float* row1 = &m_field[j*m_cols + i];
+    const float* row2 = row1 + m_cols;
+    double v = (1-fy) * ((1-fx)*row1[0] + fx*row1[1]) +
+      fy * ((1-fx)*row2[0] + fx*row2[1]);
+    if(fabs(v) >= band) {
+      gx = ((1-fy)*(row1[1]-row1[0]) + fy*(row2[1]-row2[0])) / m_cell_size;
+      gy = ((1-fx)*(row2[0]-row1[0]) + fx*(row2[1]-row1[1])) / m_cell_size;
+      return(true);
+    }
+  }
+
+  double h = m_cell_size / 100;
+  gx = (signedDistExact(px+h, py) - signedDistExact(px-h, py)) / (2*h);
+  gy = (signedDistExact(px, py+h) - signedDistExact(px, py-h)) / (2*h);
+  return(true);
+}
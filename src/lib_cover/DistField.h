@@ -0,0 +1,77 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: DistField.h                                          */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef DIST_FIELD_HEADER
+#define DIST_FIELD_HEADER
+
+#include <vector>
+#include "XYSegList.h"
+#include "XYGenPolygon.h"
+#include "BorderIndex.h"
+
+//---------------------------------------------------------------
+// A signed distance field over the bounding box of a genpoly,
+// negative inside and positive outside. Grid nodes touching the
+// border are seeded at zero and a two-pass exact Euclidean
+// distance transform (Felzenszwalb & Huttenlocher) gives every
+// other node its distance to the nearest seed in linear time.
+// Queries interpolate bilinearly. Within m_exact_band of the
+// border, or off the grid, queries fall back to exact distance
+// from the border index.
+
+class DistField {
+ public:
+  DistField();
+  ~DistField() {}
+
+  void   setGenPoly(const XYGenPolygon&);
+  void   setBorder(const XYSegList&);
+  void   setCellSize(double);
+  void   setPadding(double v)    {if(v >= 0) m_padding = v;}
+  void   setExactBand(double v)  {if(v >= 0) m_exact_band = v;}
+  void   clear();
+
+  double signedDist(double px, double py) const;
+  double dist(double px, double py) const;
+  bool   gradient(double px, double py, double& gx, double& gy) const;
+
+  double signedDistExact(double px, double py) const;
+
+  double getCellSize() const  {return(m_cell_size);}
+  double getErrorBound() const;
+  unsigned int getMemoryBytes() const {return(m_field.size()*sizeof(float));}
+
+ protected:
+  void   build();
+  void   seedNodes(std::vector<float>&) const;
+  void   applySigns();
+  void   transform1D(std::vector<float>& f, unsigned int n) const;
+  bool   cellOf(double px, double py, unsigned int& i, unsigned int& j,
+		double& fx, double& fy) const;
+
+ protected: // State vars
+  BorderIndex m_index;
+  XYSegList   m_border;
+
+  std::vector<float> m_field;
+
+  double       m_min_x;
+  double       m_min_y;
+  unsigned int m_cols;
+  unsigned int m_rows;
+
+ protected: // Config vars
+  double m_cell_size;
+  double m_padding;
+  double m_exact_band;
+};
+
+#endif
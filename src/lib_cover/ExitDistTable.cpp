@@ -0,0 +1,368 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: ExitDistTable.cpp                                    */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <thread>
+#include "ExitDistTable.h"
+#include "AngleUtils.h"
+#include "MBTimer.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+ExitDistTable::ExitDistTable()
+{
+  // Init config vars
+  m_cfg_cell_size = 2;
+  m_hdg_step      = 5;
+  m_mem_cap_mb    = 64;
+  m_threads       = 0;    // 0 means use all hardware threads
+  m_err_samples   = 2000;
+
+  // Init state vars
+  m_hdgs = 72;
+  clearTable();
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void ExitDistTable::clear()
+{
+  lock_guard<mutex> lock(m_build_mutex);
+  clearTable();
+}
+
+//---------------------------------------------------------------
+// Procedure: clearTable()
+//      Note: Callers hold the build mutex.
+
+void ExitDistTable::clearTable()
+{
+  m_table.clear();
+  m_cell_clear.clear();
+  m_built = false;
+
+  m_cell_size = m_cfg_cell_size;
+  m_cols = 0;
+  m_rows = 0;
+
+  m_build_time   = 0;
+  m_err_max      = -1;
+  m_err_avg      = -1;
+  m_fallback_pct = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: setGenPoly()
+
+void ExitDistTable::setGenPoly(const XYGenPolygon& gpoly)
+{
+  setBorder(gpoly.getSegList());
+}
+
+//---------------------------------------------------------------
+// Procedure: setBorder()
+//      Note: The table itself is not built until the first query
+//            or an explicit call to build().
+
+void ExitDistTable::setBorder(const XYSegList& segl)
+{
+  lock_guard<mutex> lock(m_build_mutex);
+  clearTable();
+  m_index.setBorder(segl);
+}
+
+//---------------------------------------------------------------
+// Procedure: setCellSize()
+
+void ExitDistTable::setCellSize(double dval)
+{
+  if(dval <= 0)
+    return;
+
+  lock_guard<mutex> lock(m_build_mutex);
+  m_cfg_cell_size = dval;
+  clearTable();
+}
+
+//---------------------------------------------------------------
+// Procedure: setHdgStep()
+//      Note: The step is adjusted to divide evenly into 360.
+
+void ExitDistTable::setHdgStep(double dval)
+{
+  if((dval <= 0) || (dval > 90))
+    return;
+
+  lock_guard<mutex> lock(m_build_mutex);
+  m_hdgs = (unsigned int)(round(360.0 / dval));
+  m_hdg_step = 360.0 / (double)(m_hdgs);
+  clearTable();
+}
+
+//---------------------------------------------------------------
+// Procedure: setMemoryCap()
+
+void ExitDistTable::setMemoryCap(double mb)
+{
+  if(mb <= 0)
+    return;
+
+  lock_guard<mutex> lock(m_build_mutex);
+  m_mem_cap_mb = mb;
+  clearTable();
+}
+
+//---------------------------------------------------------------
+// Procedure: getMemoryBytes()
+
+unsigned int ExitDistTable::getMemoryBytes() const
+{
+  return((m_table.size() * sizeof(float)) + m_cell_clear.size());
+}
+
+//---------------------------------------------------------------
+// Procedure: build()
+//   Purpose: Size the grid under the memory cap, then fill the
+//            table rows in parallel and measure the error.
+//   Returns: false if there is no border to build over.
+
+bool ExitDistTable::build() const
+{
+  if(m_built)
+    return(true);
+
+  lock_guard<mutex> lock(m_build_mutex);
+  if(m_built)
+    return(true);
+  if(m_index.size() < 3)
+    return(false);
+
+  MBTimer timer;
+  timer.start();
+
+  // Part 1: Size the grid, coarsening until under the memory cap
+  double wid = m_index.getMaxX() - m_index.getMinX();
+  double hgt = m_index.getMaxY() - m_index.getMinY();
+  double cap_bytes = m_mem_cap_mb * 1024 * 1024;
+
+  m_cell_size = m_cfg_cell_size;
+  while(true) {
+    m_cols = (unsigned int)(ceil(wid / m_cell_size)) + 1;
+    m_rows = (unsigned int)(ceil(hgt / m_cell_size)) + 1;
+    double bytes = (double)(m_cols) * m_rows * ((m_hdgs * sizeof(float)) + 1);
+    if(bytes <= cap_bytes)
+      break;
+    m_cell_size *= sqrt(bytes / cap_bytes) * 1.01;
+  }
+  m_table.assign(m_cols * m_rows * m_hdgs, -1);
+  m_cell_clear.assign(m_cols * m_rows, 0);
+
+  // Part 2: Fill the table, one band of rows per thread
+  unsigned int threads = m_threads;
+  if(threads == 0)
+    threads = thread::hardware_concurrency();
+  if(threads == 0)
+    threads = 1;
+  if(threads > m_rows)
+    threads = m_rows;
+
+  vector<thread> workers;
+  unsigned int band = (m_rows + threads - 1) / threads;
+  for(unsigned int t=0; t<threads; t++) {
+    unsigned int row1 = t * band;
+    unsigned int row2 = min(m_rows, row1 + band);
+    if(row1 < row2)
+      workers.push_back(thread(&ExitDistTable::buildRows, this, row1, row2));
+  }
+  for(unsigned int t=0; t<workers.size(); t++)
+    workers[t].join();
+
+  timer.stop();
+  m_build_time = timer.get_float_wall_time();
+
+  // Part 3: Measure the interpolation error against exact queries
+  measureError();
+
+  // Published last, so readers that see it without the lock also
+  // see the table and its stats complete
+  m_built = true;
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: buildRows()
+//      Note: Nodes outside the genpoly are left at -1, which marks
+//            them as unusable for interpolation. Each cell, with
+//            its lower left node in these rows, is marked clear if
+//            the border does not pass through it.
+
+void ExitDistTable::buildRows(unsigned int row1, unsigned int row2) const
+{
+  double min_x = m_index.getMinX();
+  double min_y = m_index.getMinY();
+
+  for(unsigned int j=row1; j<row2; j++) {
+    double py = min_y + j * m_cell_size;
+    for(unsigned int i=0; i<m_cols; i++) {
+      double px = min_x + i * m_cell_size;
+      if(!m_index.contains(px, py))
+	continue;
+
+      if(((i+1) < m_cols) && ((j+1) < m_rows))
+	m_cell_clear[j*m_cols + i] =
+	  !m_index.crossesBox(px, py, px+m_cell_size, py+m_cell_size);
+
+      unsigned int base = (j*m_cols + i) * m_hdgs;
+      for(unsigned int k=0; k<m_hdgs; k++) {
+	double dist = m_index.distRayToBorder(px, py, k * m_hdg_step);
+	if(dist < 0)
+	  dist = 0;
+	m_table[base + k] = (float)(dist);
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------
+// Procedure: lookup()
+//   Purpose: Interpolate the table at the given pose.
+//   Returns: false if the pose is off the table, any of the four
+//            surrounding nodes lies outside the genpoly, or the
+//            border passes through the cell.
+
+bool ExitDistTable::lookup(double px, double py, double hdg,
+			   double& dist) const
+{
+  double gx = (px - m_index.getMinX()) / m_cell_size;
+  double gy = (py - m_index.getMinY()) / m_cell_size;
+  if((gx < 0) || (gy < 0))
+    return(false);
+
+  unsigned int i = (unsigned int)(gx);
+  unsigned int j = (unsigned int)(gy);
+  if(((i+1) >= m_cols) || ((j+1) >= m_rows))
+    return(false);
+
+  if(!m_cell_clear[j*m_cols + i])
+    return(false);
+
+  double fx = gx - i;
+  double fy = gy - j;
+
+  double gh = angle360(hdg) / m_hdg_step;
+  unsigned int k1 = ((unsigned int)(gh)) % m_hdgs;
+  unsigned int k2 = (k1 + 1) % m_hdgs;
+  double fh = gh - floor(gh);
+
+  const float* n00 = &m_table[((j  )*m_cols + i  ) * m_hdgs];
+  const float* n10 = &m_table[((j  )*m_cols + i+1) * m_hdgs];
+  const float* n01 = &m_table[((j+1)*m_cols + i  ) * m_hdgs];
+  const float* n11 = &m_table[((j+1)*m_cols + i+1) * m_hdgs];
+  if((n00[0] < 0) || (n10[0] < 0) || (n01[0] < 0) || (n11[0] < 0))
+    return(false);
+
+  double w00 = (1-fx) * (1-fy);
+  double w10 = fx * (1-fy);
+  double w01 = (1-fx) * fy;
+  double w11 = fx * fy;
+
+  double d1 = w00*n00[k1] + w10*n10[k1] + w01*n01[k1] + w11*n11[k1];
+  double d2 = w00*n00[k2] + w10*n10[k2] + w01*n01[k2] + w11*n11[k2];
+
+  dist = d1 + fh * (d2 - d1);
+  return(true);
+}
+
+//---------------------------------------------------------------
+// Procedure: distRayToExit()
+
+double ExitDistTable::distRayToExit(double px, double py, double hdg) const
+{
+  if(!m_built && !build())
+    return(-1);
+
+  double dist = 0;
+  if(lookup(px, py, hdg, dist))
+    return(dist);
+
+  return(m_index.distRayToExit(px, py, hdg));
+}
+
+//---------------------------------------------------------------
+// Procedure: distRayToExitExact()
+
+double ExitDistTable::distRayToExitExact(double px, double py,
+					 double hdg) const
+{
+  return(m_index.distRayToExit(px, py, hdg));
+}
+
+//---------------------------------------------------------------
+// Procedure: measureError()
+//   Purpose: Compare interpolated and exact values at a fixed,
+//            reproducible set of sample poses within the genpoly.
+//            The reported bound is empirical. The exit distance is
+//            discontinuous where a ray grazes a border vertex, so
+//            no useful analytic bound exists for interpolation.
+
+void ExitDistTable::measureError() const
+{
+  double min_x = m_index.getMinX();
+  double min_y = m_index.getMinY();
+  double wid = m_index.getMaxX() - min_x;
+  double hgt = m_index.getMaxY() - min_y;
+
+  unsigned long int seed = 1;
+  unsigned int samples = 0;
+  unsigned int fallbacks = 0;
+  double err_sum = 0;
+  double err_max = 0;
+
+  for(unsigned int n=0; n<m_err_samples; n++) {
+    seed = (seed * 6364136223846793005UL) + 1442695040888963407UL;
+    double r1 = (double)((seed >> 11) & 0xFFFFF) / (double)(0x100000);
+    seed = (seed * 6364136223846793005UL) + 1442695040888963407UL;
+    double r2 = (double)((seed >> 11) & 0xFFFFF) / (double)(0x100000);
+    seed = (seed * 6364136223846793005UL) + 1442695040888963407UL;
+    double r3 = (double)((seed >> 11) & 0xFFFFF) / (double)(0x100000);
+
+    double px  = min_x + r1 * wid;
+    double py  = min_y + r2 * hgt;
+    double hdg = r3 * 360;
+    if(!m_index.contains(px, py))
+      continue;
+
+    double dist = 0;
+    if(!lookup(px, py, hdg, dist)) {
+      fallbacks++;
+      continue;
+    }
+
+    double err = fabs(dist - m_index.distRayToExit(px, py, hdg));
+    err_sum += err;
+    if(err > err_max)
+      err_max = err;
+    samples++;
+  }
+
+  m_err_max = err_max;
+  m_err_avg = 0;
+  if(samples > 0)
+    m_err_avg = err_sum / (double)(samples);
+
+  m_fallback_pct = 0;
+  if((samples + fallbacks) > 0)
+    m_fallback_pct = (100.0 * fallbacks) / (double)(samples + fallbacks);
+}
@@ -0,0 +1,98 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: ExitDistTable.h                                      */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef EXIT_DIST_TABLE_HEADER
+#define EXIT_DIST_TABLE_HEADER
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include "XYSegList.h"
+#include "XYGenPolygon.h"
+#include "BorderIndex.h"
+
+//---------------------------------------------------------------
+// A precomputed table of the distance-to-exit along a heading,
+// sampled on a grid of positions over the genpoly bounding box
+// and a set of discrete headings. Queries interpolate bilinearly
+// in position and linearly in heading. Where any of the four
+// surrounding grid nodes lies outside the genpoly, or the border
+// passes through the grid cell, the query falls back to the exact
+// (indexed) ray query. A cell the border misses, with its nodes
+// inside, lies wholly inside, so no query point in a concave
+// notch is ever interpolated.
+//
+// The table is built lazily on the first query, split by rows
+// over a number of threads. If the requested resolution would
+// exceed the memory cap, the position grid is coarsened.
+
+class ExitDistTable {
+ public:
+  ExitDistTable();
+  ~ExitDistTable() {}
+
+  void   setGenPoly(const XYGenPolygon&);
+  void   setBorder(const XYSegList&);
+  void   setCellSize(double);
+  void   setHdgStep(double);
+  void   setMemoryCap(double mb);
+  void   setThreads(unsigned int v) {m_threads = v;}
+  void   setErrorSamples(unsigned int v) {m_err_samples = v;}
+  void   clear();
+
+  double distRayToExit(double px, double py, double hdg) const;
+  double distRayToExitExact(double px, double py, double hdg) const;
+
+  bool   build() const;
+  bool   isBuilt() const {return(m_built);}
+
+  double getCellSize() const   {return(m_cell_size);}
+  double getHdgStep() const    {return(m_hdg_step);}
+  double getBuildTime() const  {return(m_build_time);}
+  double getErrorMax() const   {return(m_err_max);}
+  double getErrorAvg() const   {return(m_err_avg);}
+  double getFallbackPct() const {return(m_fallback_pct);}
+  unsigned int getMemoryBytes() const;
+
+ protected:
+  void   clearTable();
+  void   buildRows(unsigned int row1, unsigned int row2) const;
+  void   measureError() const;
+  bool   lookup(double px, double py, double hdg, double& dist) const;
+
+ protected: // State vars. Mutable since the build is lazy and
+            // is triggered from within const queries.
+  BorderIndex m_index;
+
+  mutable std::vector<float> m_table;
+  mutable std::vector<unsigned char> m_cell_clear;
+  mutable std::mutex         m_build_mutex;
+  mutable std::atomic<bool>  m_built;
+
+  mutable double       m_cell_size;
+  mutable unsigned int m_cols;
+  mutable unsigned int m_rows;
+  unsigned int         m_hdgs;
+
+  mutable double m_build_time;
+  mutable double m_err_max;
+  mutable double m_err_avg;
+  mutable double m_fallback_pct;
+
+ protected: // Config vars
+  double       m_cfg_cell_size;
+  double       m_hdg_step;
+  double       m_mem_cap_mb;
+  unsigned int m_threads;
+  unsigned int m_err_samples;
+};
+
+#endif
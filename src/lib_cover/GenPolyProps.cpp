@@ -0,0 +1,132 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: GenPolyProps.cpp                                     */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include "GenPolyProps.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+//      Note: Area and centroid are summed over the cover pieces,
+//            each by the shoelace formula. The bounding box and
+//            perimeter are taken from the border.
+
+GenPolyProps::GenPolyProps(const XYGenPolygon& gpoly)
+{
+  m_area = 0;
+  m_perimeter  = 0;
+  m_centroid_x = 0;
+  m_centroid_y = 0;
+  m_min_x = 0;
+  m_min_y = 0;
+  m_max_x = 0;
+  m_max_y = 0;
+  m_all_convex = true;
+
+  // Part 1: Bounding box and perimeter of the border
+  XYSegList segl = gpoly.getSegList();
+  unsigned int vsize = segl.size();
+  for(unsigned int i=0; i<vsize; i++) {
+    double x1 = segl.get_vx(i);
+    double y1 = segl.get_vy(i);
+    double x2 = segl.get_vx((i+1) % vsize);
+    double y2 = segl.get_vy((i+1) % vsize);
+    if((i == 0) || (x1 < m_min_x))
+      m_min_x = x1;
+    if((i == 0) || (x1 > m_max_x))
+      m_max_x = x1;
+    if((i == 0) || (y1 < m_min_y))
+      m_min_y = y1;
+    if((i == 0) || (y1 > m_max_y))
+      m_max_y = y1;
+    if(vsize > 1)
+      m_perimeter += hypot(x2-x1, y2-y1);
+  }
+
+  // Part 2: Area, centroid and convexity of each cover piece
+  double sum_cx = 0;
+  double sum_cy = 0;
+  vector<XYPolygon> polys = gpoly.getCoverPolys();
+  for(unsigned int i=0; i<polys.size(); i++) {
+    double twice_area = 0;
+    double cx = 0;
+    double cy = 0;
+    unsigned int psize = polys[i].size();
+    for(unsigned int j=0; j<psize; j++) {
+      double x1 = polys[i].get_vx(j);
+      double y1 = polys[i].get_vy(j);
+      double x2 = polys[i].get_vx((j+1) % psize);
+      double y2 = polys[i].get_vy((j+1) % psize);
+      double cross = (x1*y2) - (x2*y1);
+      twice_area += cross;
+      cx += (x1 + x2) * cross;
+      cy += (y1 + y2) * cross;
+    }
+    double area = fabs(twice_area) / 2;
+    m_piece_area.push_back(area);
+    m_area += area;
+
+    // Signed sums give the centroid regardless of vertex order
+    if(twice_area != 0) {
+      sum_cx += area * cx / (3 * twice_area);
+      sum_cy += area * cy / (3 * twice_area);
+    }
+
+    bool convex = polys[i].is_convex();
+    m_piece_convex.push_back(convex);
+    if(!convex)
+      m_all_convex = false;
+  }
+
+  if(m_area > 0) {
+    m_centroid_x = sum_cx / m_area;
+    m_centroid_y = sum_cy / m_area;
+  }
+}
+
+//---------------------------------------------------------------
+// Constructor()
+//   Purpose: Props of the given genpoly after a rigid transform,
+//            taking the moved centroid and bounding box.
+
+GenPolyProps::GenPolyProps(const GenPolyProps& props, double cx, double cy,
+			   double min_x, double min_y,
+			   double max_x, double max_y)
+{
+  *this = props;
+  m_centroid_x = cx;
+  m_centroid_y = cy;
+  m_min_x = min_x;
+  m_min_y = min_y;
+  m_max_x = max_x;
+  m_max_y = max_y;
+}
+
+//---------------------------------------------------------------
+// Procedure: getPieceArea()
+
+double GenPolyProps::getPieceArea(unsigned int ix) const
+{
+  if(ix >= m_piece_area.size())
+    return(0);
+  return(m_piece_area[ix]);
+}
+
+//---------------------------------------------------------------
+// Procedure: isPieceConvex()
+
+bool GenPolyProps::isPieceConvex(unsigned int ix) const
+{
+  if(ix >= m_piece_convex.size())
+    return(false);
+  return(m_piece_convex[ix]);
+}
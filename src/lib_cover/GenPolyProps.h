@@ -0,0 +1,66 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: GenPolyProps.h                                       */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef GEN_POLY_PROPS_HEADER
+#define GEN_POLY_PROPS_HEADER
+
+#include <vector>
+#include "XYGenPolygon.h"
+
+//---------------------------------------------------------------
+// Derived properties of a genpoly, computed once on construction
+// and never modified after. Intended to be handed out as a shared
+// pointer to const, so readers on any thread may hold a snapshot
+// while the owner moves on to new geometry. Area, perimeter and
+// convexity are unchanged by a rigid transform, so the props of a
+// moved genpoly are made from those of the unmoved one, given the
+// moved centroid and bounding box.
+
+class GenPolyProps {
+ public:
+  GenPolyProps(const XYGenPolygon&);
+  GenPolyProps(const GenPolyProps&, double cx, double cy,
+	       double min_x, double min_y, double max_x, double max_y);
+  ~GenPolyProps() {}
+
+  double getArea() const       {return(m_area);}
+  double getPerimeter() const  {return(m_perimeter);}
+  double getCentroidX() const  {return(m_centroid_x);}
+  double getCentroidY() const  {return(m_centroid_y);}
+
+  double getMinX() const  {return(m_min_x);}
+  double getMinY() const  {return(m_min_y);}
+  double getMaxX() const  {return(m_max_x);}
+  double getMaxY() const  {return(m_max_y);}
+
+  unsigned int getPieceCount() const {return(m_piece_area.size());}
+
+  double getPieceArea(unsigned int) const;
+  bool   isPieceConvex(unsigned int) const;
+  bool   allPiecesConvex() const {return(m_all_convex);}
+
+ protected:
+  double m_area;
+  double m_perimeter;
+  double m_centroid_x;
+  double m_centroid_y;
+
+  double m_min_x;
+  double m_min_y;
+  double m_max_x;
+  double m_max_y;
+
+  std::vector<double> m_piece_area;
+  std::vector<bool>   m_piece_convex;
+  bool                m_all_convex;
+};
+
+#endif
@@ -0,0 +1,363 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: GenPolyShape.cpp                                     */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#include <cmath>
+#include <utility>
+#include "GenPolyShape.h"
+#include "AngleUtils.h"
+
+using namespace std;
+
+//---------------------------------------------------------------
+// Constructor()
+
+GenPolyShape::GenPolyShape()
+{
+  clear();
+}
+
+//---------------------------------------------------------------
+// Procedure: clear()
+
+void GenPolyShape::clear()
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  clearAll();
+}
+
+//---------------------------------------------------------------
+// Procedure: clearAll()
+//      Note: Caller holds m_cache_mutex.
+
+void GenPolyShape::clearAll()
+{
+  m_base.clear();
+  m_folded.clear();
+  m_folded_ok = false;
+  m_base_props.reset();
+  m_props.reset();
+
+  m_cos = 1;
+  m_sin = 0;
+  m_tx  = 0;
+  m_ty  = 0;
+}
+
+//---------------------------------------------------------------
+// Procedure: setGenPoly()
+
+void GenPolyShape::setGenPoly(const XYGenPolygon& gpoly)
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  clearAll();
+  m_base = gpoly;
+}
+
+//---------------------------------------------------------------
+// Procedure: shiftHorz()
+
+void GenPolyShape::shiftHorz(double amt)
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  m_tx += amt;
+  invalidate();
+}
+
+//---------------------------------------------------------------
+// Procedure: shiftVert()
+
+void GenPolyShape::shiftVert(double amt)
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  m_ty += amt;
+  invalidate();
+}
+
+//---------------------------------------------------------------
+// Procedure: rotate()
+//   Purpose: Rotate about cx,cy by the given degrees, clockwise
+//            for positive values, matching XYSegList::rotate().
+
+void GenPolyShape::rotate(double degs, double cx, double cy)
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  double rads = -degs * M_PI / 180.0;
+  double rc = cos(rads);
+  double rs = sin(rads);
+
+  // Compose: world' = Rot * (world - c) + c
+  double new_cos = rc*m_cos - rs*m_sin;
+  double new_sin = rs*m_cos + rc*m_sin;
+  double new_tx  = rc*(m_tx - cx) - rs*(m_ty - cy) + cx;
+  double new_ty  = rs*(m_tx - cx) + rc*(m_ty - cy) + cy;
+
+  m_cos = new_cos;
+  m_sin = new_sin;
+  m_tx  = new_tx;
+  m_ty  = new_ty;
+  invalidate();
+}
+
+//---------------------------------------------------------------
+// Procedure: invalidate()
+//      Note: Caller holds m_cache_mutex.
+//      Note: Snapshots already handed out remain valid for their
+//            holders. They describe the geometry as it was.
+
+void GenPolyShape::invalidate()
+{
+  m_folded_ok = false;
+  m_props.reset();
+}
+
+//---------------------------------------------------------------
+// Procedure: isIdentity()
+
+bool GenPolyShape::isIdentity() const
+{
+  return((m_cos == 1) && (m_sin == 0) && (m_tx == 0) && (m_ty == 0));
+}
+
+//---------------------------------------------------------------
+// Procedure: toBase()
+
+void GenPolyShape::toBase(double wx, double wy,
+			  double& bx, double& by) const
+{
+  double dx = wx - m_tx;
+  double dy = wy - m_ty;
+  bx =  m_cos*dx + m_sin*dy;
+  by = -m_sin*dx + m_cos*dy;
+}
+
+//---------------------------------------------------------------
+// Procedure: toWorld()
+
+void GenPolyShape::toWorld(double bx, double by,
+			   double& wx, double& wy) const
+{
+  wx = m_cos*bx - m_sin*by + m_tx;
+  wy = m_sin*bx + m_cos*by + m_ty;
+}
+
+//---------------------------------------------------------------
+// Procedure: toBaseHdg()
+//   Purpose: Map a world heading into the solved frame. Headings
+//            run clockwise, as do rotations, so the accumulated
+//            rotation is taken off.
+
+double GenPolyShape::toBaseHdg(double hdg) const
+{
+  double rot_degs = -atan2(m_sin, m_cos) * 180.0 / M_PI;
+  return(angle360(hdg - rot_degs));
+}
+
+//---------------------------------------------------------------
+// Procedure: toBase()
+//   Purpose: Map each vertex of a world seglist into the solved
+//            frame.
+
+XYSegList GenPolyShape::toBase(const XYSegList& segl) const
+{
+  XYSegList base_segl;
+  for(unsigned int i=0; i<segl.size(); i++) {
+    double bx, by;
+    toBase(segl.get_vx(i), segl.get_vy(i), bx, by);
+    base_segl.add_vertex(bx, by);
+  }
+  return(base_segl);
+}
+
+//---------------------------------------------------------------
+// Procedure: toBase()
+//   Purpose: Map a world seglr, vertices and ray heading, into the
+//            solved frame.
+
+XYSeglr GenPolyShape::toBase(const XYSeglr& seglr) const
+{
+  XYSegList base_segl = toBase(seglr.getBaseSegList());
+
+  XYSeglr base_seglr;
+  for(unsigned int i=0; i<base_segl.size(); i++)
+    base_seglr.addVertex(base_segl.get_vx(i), base_segl.get_vy(i));
+  base_seglr.setRayAngle(toBaseHdg(seglr.getRayAngle()));
+  return(base_seglr);
+}
+
+//---------------------------------------------------------------
+// Procedure: contains()
+
+bool GenPolyShape::contains(double px, double py) const
+{
+  double bx, by;
+  toBase(px, py, bx, by);
+  return(m_base.contains(bx, by));
+}
+
+//---------------------------------------------------------------
+// Procedure: dist_to_poly()
+
+double GenPolyShape::dist_to_poly(double px, double py) const
+{
+  double bx, by;
+  toBase(px, py, bx, by);
+  return(m_base.dist_to_poly(bx, by));
+}
+
+//---------------------------------------------------------------
+// Procedure: dist_to_poly()
+
+double GenPolyShape::dist_to_poly(double x1, double y1,
+				  double x2, double y2) const
+{
+  double bx1, by1, bx2, by2;
+  toBase(x1, y1, bx1, by1);
+  toBase(x2, y2, bx2, by2);
+  return(m_base.dist_to_poly(bx1, by1, bx2, by2));
+}
+
+//---------------------------------------------------------------
+// Procedure: line_intersects()
+
+bool GenPolyShape::line_intersects(double x1, double y1,
+				   double x2, double y2) const
+{
+  double bx1, by1, bx2, by2;
+  toBase(x1, y1, bx1, by1);
+  toBase(x2, y2, bx2, by2);
+  return(m_base.line_intersects(bx1, by1, bx2, by2));
+}
+
+//---------------------------------------------------------------
+// Procedure: getGenPoly()
+//   Purpose: Return the genpoly in the world frame, folding the
+//            transform into the geometry first if it has changed.
+
+const XYGenPolygon& GenPolyShape::getGenPoly() const
+{
+  return(worldFrame());
+}
+
+//---------------------------------------------------------------
+// Procedure: getSegList()
+//   Purpose: Border in the world frame, without a copy.
+
+const XYSegList& GenPolyShape::getSegList() const
+{
+  return(worldFrame().getSegListRef());
+}
+
+//---------------------------------------------------------------
+// Procedure: getCoverPolys()
+//   Purpose: Cover pieces in the world frame, without a copy.
+
+const vector<XYPolygon>& GenPolyShape::getCoverPolys() const
+{
+  return(worldFrame().getCoverPolysRef());
+}
+
+//---------------------------------------------------------------
+// Procedure: worldFrame()
+//   Purpose: The base genpoly if there is no transform, otherwise
+//            the folded one, folding first if stale.
+
+const GenPolyFrame& GenPolyShape::worldFrame() const
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  if(isIdentity())
+    return(m_base);
+  if(!m_folded_ok)
+    fold();
+  return(m_folded);
+}
+
+//---------------------------------------------------------------
+// Procedure: getProps()
+//   Purpose: Return the snapshot of derived properties, building
+//            it on the first request since the last change.
+//      Note: The base props are computed once per genpoly. After a
+//            move, only the centroid and the bounding box of the
+//            border vertices are mapped into the world frame, and
+//            nothing is folded.
+
+shared_ptr<const GenPolyProps> GenPolyShape::getProps() const
+{
+  lock_guard<mutex> lock(m_cache_mutex);
+  if(m_props)
+    return(m_props);
+
+  if(!m_base_props)
+    m_base_props = make_shared<const GenPolyProps>(m_base);
+  if(isIdentity()) {
+    m_props = m_base_props;
+    return(m_props);
+  }
+
+  double cx, cy;
+  toWorld(m_base_props->getCentroidX(), m_base_props->getCentroidY(), cx, cy);
+
+  double min_x = 0;
+  double min_y = 0;
+  double max_x = 0;
+  double max_y = 0;
+  const XYSegList& base_segl = m_base.getSegListRef();
+  for(unsigned int i=0; i<base_segl.size(); i++) {
+    double wx, wy;
+    toWorld(base_segl.get_vx(i), base_segl.get_vy(i), wx, wy);
+    if((i == 0) || (wx < min_x))
+      min_x = wx;
+    if((i == 0) || (wx > max_x))
+      max_x = wx;
+    if((i == 0) || (wy < min_y))
+      min_y = wy;
+    if((i == 0) || (wy > max_y))
+      max_y = wy;
+  }
+
+  m_props = make_shared<const GenPolyProps>(*m_base_props, cx, cy,
+					    min_x, min_y, max_x, max_y);
+  return(m_props);
+}
+
+//---------------------------------------------------------------
+// Procedure: fold()
+//      Note: Caller holds m_cache_mutex.
+//      Note: Rigid transforms preserve convexity, but it is still
+//            determined once per piece since the vertices are new.
+
+void GenPolyShape::fold() const
+{
+  const XYSegList& base_segl = m_base.getSegListRef();
+  XYSegList segl;
+  for(unsigned int i=0; i<base_segl.size(); i++) {
+    double wx, wy;
+    toWorld(base_segl.get_vx(i), base_segl.get_vy(i), wx, wy);
+    segl.add_vertex(wx, wy);
+  }
+
+  const vector<XYPolygon>& base_polys = m_base.getCoverPolysRef();
+  vector<XYPolygon> polys;
+  for(unsigned int i=0; i<base_polys.size(); i++) {
+    const XYPolygon& base_poly = base_polys[i];
+    XYPolygon poly;
+    for(unsigned int j=0; j<base_poly.size(); j++) {
+      double wx, wy;
+      toWorld(base_poly.get_vx(j), base_poly.get_vy(j), wx, wy);
+      poly.add_vertex(wx, wy, false);
+    }
+    poly.determine_convexity();
+    poly.set_label(base_poly.get_label());
+    polys.push_back(poly);
+  }
+
+  m_folded.setGenPoly(move(segl), move(polys));
+  m_folded_ok = true;
+}
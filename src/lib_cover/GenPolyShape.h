@@ -0,0 +1,118 @@
+/*****************************************************************/
+/*    NAME: Michael Benjamin                                     */
+/*    ORGN: Dept of Mechanical Engineering, MIT, Cambridge MA    */
+/*    FILE: GenPolyShape.h                                       */
+/*    DATE: Oct 19th, 2026                                       */
+/*                                                               */
+/* This is unreleased BETA code. No permission is granted or     */
+/* implied to use, copy, modify, and distribute this software    */
+/* except by the author(s), or those designated by the author.   */
+/*****************************************************************/
+
+#ifndef GEN_POLY_SHAPE_HEADER
+#define GEN_POLY_SHAPE_HEADER
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "XYGenPolygon.h"
+#include "XYSeglr.h"
+#include "GenPolyProps.h"
+
+//---------------------------------------------------------------
+// An XYGenPolygon whose border and cover pieces can be read in
+// place, by const reference, rather than copied out.
+
+class GenPolyFrame : public XYGenPolygon {
+ public:
+  GenPolyFrame() {}
+  GenPolyFrame(const XYGenPolygon& gpoly) : XYGenPolygon(gpoly) {}
+  ~GenPolyFrame() {}
+
+  const XYSegList& getSegListRef() const {return(m_segl);}
+  const std::vector<XYPolygon>& getCoverPolysRef() const
+  {return(m_cover_polys);}
+};
+
+//---------------------------------------------------------------
+// A genpoly held in its solved frame plus a rigid transform
+// (rotation then translation). Translation and rotation preserve
+// the cover, so shifting or rotating only updates the transform.
+// Queries map the query point back into the solved frame. Indexes
+// built over the genpoly, e.g., a BorderIndex, are best built once
+// over the base genpoly and queried through toBase(), which maps
+// points, headings, seglists and seglrs. The transformed genpoly
+// is folded out only when asked for, e.g., to draw or export it,
+// and cached until the transform changes again. The geometry is
+// held once per frame, and while the transform is the identity
+// the world genpoly is the base genpoly itself. Derived properties
+// (area, bounding box, centroid, perimeter, piece convexity) are
+// computed from the base genpoly on first request. After a move
+// only the centroid and bounding box are mapped to the world.
+//
+// Threads: const members may be called from several threads at
+// once. The fold and props are built under a mutex. Non-const
+// members (set, clear, shift, rotate) must not overlap any other
+// call, and they leave references from getGenPoly(), getSegList()
+// and getCoverPolys() stale. A snapshot from getProps() stays
+// valid, describing the geometry as it was when taken.
+
+class GenPolyShape {
+ public:
+  GenPolyShape();
+  ~GenPolyShape() {}
+
+  void   setGenPoly(const XYGenPolygon&);
+  void   clear();
+
+  void   shiftHorz(double);
+  void   shiftVert(double);
+  void   rotate(double degs, double cx, double cy);
+
+  bool   contains(double px, double py) const;
+  double dist_to_poly(double px, double py) const;
+  double dist_to_poly(double x1, double y1, double x2, double y2) const;
+  bool   line_intersects(double x1, double y1, double x2, double y2) const;
+
+  const XYGenPolygon& getGenPoly() const;
+  const XYGenPolygon& getBaseGenPoly() const {return(m_base);}
+  const XYSegList&    getSegList() const;
+  const std::vector<XYPolygon>& getCoverPolys() const;
+
+  std::shared_ptr<const GenPolyProps> getProps() const;
+
+  double area() const  {return(getProps()->getArea());}
+
+  bool   isIdentity() const;
+  unsigned int getPolyCount() const {return(m_base.getPolyCount());}
+
+  void   toBase(double wx, double wy, double& bx, double& by) const;
+  void   toWorld(double bx, double by, double& wx, double& wy) const;
+  double toBaseHdg(double hdg) const;
+
+  XYSegList toBase(const XYSegList&) const;
+  XYSeglr   toBase(const XYSeglr&) const;
+
+ protected:
+  const GenPolyFrame& worldFrame() const;
+  void   fold() const;
+  void   invalidate();
+  void   clearAll();
+
+ protected: // State vars
+  GenPolyFrame m_base;
+
+  double m_cos;
+  double m_sin;
+  double m_tx;
+  double m_ty;
+
+  mutable GenPolyFrame m_folded;
+  mutable bool         m_folded_ok;
+  mutable std::mutex   m_cache_mutex;
+
+  mutable std::shared_ptr<const GenPolyProps> m_base_props;
+  mutable std::shared_ptr<const GenPolyProps> m_props;
+};
+
+#endif